@@ -0,0 +1,132 @@
+//
+// OwnerAccessBenchmark.cpp
+//
+// @author Roberto Cano
+//
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "Framework/Core/GameObject.hpp"
+#include "Framework/Core/GameComponent.hpp"
+#include "Framework/Core/TransformHierarchy.hpp"
+
+using namespace Framework;
+using namespace Framework::Core;
+
+//
+// Compares GameObjectOwner::getOwner<T>() against the weak_ptr lock plus dynamic_cast it replaced.
+// Each component reads its owner world position, as SpriteRenderer and the animations do every frame
+//
+
+namespace OwnerAccessBenchmarkConstants
+{
+	const size_t NumOwners = 1024;
+	const size_t NumComponentsPerOwner = 4;
+	const size_t NumIterations = 2000;
+}
+
+namespace
+{
+	class BenchmarkOwner : public Core::GameObject
+	{
+		// Empty on purpose, gives the typed accessors a real downcast to do
+	};
+
+	// What GameObjectOwner used to do on every call
+	class LockingOwner
+	{
+	public:
+		void setOwner(Types::GameObject::WeakPtrType gameObject)
+		{
+			_gameObject = std::move(gameObject);
+		}
+
+		template<typename T>
+		const T& getOwner() const
+		{
+			auto gameObjectPtr = _gameObject.lock();
+			assert(gameObjectPtr);
+			return dynamic_cast<const T&>(*gameObjectPtr);
+		}
+
+	private:
+		Types::GameObject::WeakPtrType _gameObject;
+	};
+
+	class OwnerReader : public GameComponent
+	{
+	public:
+		LockingOwner lockingOwner;
+	};
+
+	template<typename AccessFunction>
+	double MeasureNanosecondsPerAccess(const std::vector<std::shared_ptr<OwnerReader>>& readers, AccessFunction access)
+	{
+		using namespace OwnerAccessBenchmarkConstants;
+
+		// Keeps the loads alive
+		volatile float sink = 0.0f;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t iteration = 0; iteration < NumIterations; ++iteration)
+		{
+			float sum = 0.0f;
+			for (const std::shared_ptr<OwnerReader>& reader : readers)
+			{
+				sum += access(*reader);
+			}
+			sink = sink + sum;
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		const double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		return nanoseconds / static_cast<double>(NumIterations * readers.size());
+	}
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	using namespace OwnerAccessBenchmarkConstants;
+
+	std::vector<std::shared_ptr<BenchmarkOwner>> owners;
+	std::vector<std::shared_ptr<OwnerReader>> readers;
+	owners.reserve(NumOwners);
+	readers.reserve(NumOwners * NumComponentsPerOwner);
+
+	for (size_t i = 0; i < NumOwners; ++i)
+	{
+		auto owner = std::make_shared<BenchmarkOwner>();
+		owner->setLocalPosition(Point2D(static_cast<float>(i), 0.0f));
+
+		for (size_t j = 0; j < NumComponentsPerOwner; ++j)
+		{
+			auto reader = std::make_shared<OwnerReader>();
+			reader->_setOwner(owner.get());
+			reader->lockingOwner.setOwner(owner);
+			readers.push_back(std::move(reader));
+		}
+		owners.push_back(std::move(owner));
+	}
+
+	// Render path reads come after the frame transform pass, as in Engine::callUpdate()
+	TransformHierarchy::Get().updateWorldTransforms();
+
+	const double lockingTime = MeasureNanosecondsPerAccess(readers, [](const OwnerReader& reader)
+	{
+		return reader.lockingOwner.getOwner<BenchmarkOwner>().getWorldPosition().x;
+	});
+	const double rawTime = MeasureNanosecondsPerAccess(readers, [](const OwnerReader& reader)
+	{
+		return reader.getOwner<BenchmarkOwner>().getWorldPosition().x;
+	});
+
+	std::printf("Owner access, %zu components, %zu iterations\n", readers.size(), NumIterations);
+	std::printf("  weak_ptr lock + dynamic_cast : %6.2f ns/access\n", lockingTime);
+	std::printf("  getOwner<T>()                : %6.2f ns/access\n", rawTime);
+	std::printf("  speedup                      : %6.2fx\n", lockingTime / rawTime);
+
+	return 0;
+}
@@ -0,0 +1,539 @@
+//
+// HeadlessEngine.cpp
+//
+// @author Roberto Cano
+//
+
+#include "HeadlessEngine.hpp"
+#include "SDLTextureLoader.hpp"
+
+#include "Framework/Core/GameObject.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include <sdl/SDL.h>
+#include <sdl/SDL_image.h>
+
+using namespace Headless;
+
+namespace HeadlessEngineConstants
+{
+	// Must match SDL::Engine so both backends measure text the same way
+	const int InterLetterAdvance = 3;
+	// Profiling runs have to be comparable, so they never pick a seed at random
+	const uint64_t DefaultRandomSeed = 0x5EED;
+	const std::vector<float> NoYOffsets;
+}
+
+EngineOwner Engine::Create(const Settings& settings, const HeadlessSettings& headlessSettings)
+{
+	// Not make_shared, the protected constructor has to be reachable on every standard library
+	return EngineOwner(new Engine(settings, headlessSettings));
+}
+
+Engine::Engine(const Settings& settings, const HeadlessSettings& headlessSettings)
+	: _headlessSettings(headlessSettings)
+	, _assetsDirectoryPath(settings.assetsDirectoryPath)
+	, _windowSize(settings.windowSize)
+	, _mousePosition(settings.windowSize.width * 0.5f, settings.windowSize.height * 0.5f)
+	, _lastFrameSeconds(headlessSettings.fixedDeltaTime > 0.0f ? headlessSettings.fixedDeltaTime : 1.0f / 60.0f)
+{
+	settings.validate();
+
+	if (settings.fontDescriptorFileName.empty()) {
+		addFont(SDL::Font::CreateBuiltIn(settings.fontFileName), settings.fontFileName);
+	}
+	else {
+		registerFont(settings.fontDescriptorFileName);
+	}
+
+	createJobSystem(settings.numUpdateThreads);
+	seedRandom(settings.randomSeed != 0 ? settings.randomSeed : HeadlessEngineConstants::DefaultRandomSeed);
+}
+
+Engine::~Engine()
+{
+	for (auto& textureIter : _textureMapById) {
+		if (textureIter.second.cpuCopy != nullptr) {
+			SDL_FreeSurface(textureIter.second.cpuCopy);
+		}
+	}
+}
+
+void Engine::start(Framework::Types::GameObject::PtrType updater)
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	assert(updater);
+
+	_updater = updater;
+
+	_updater->setEngine(shared_from_this());
+	callStart(_updater);
+
+	_isStopRequested = false;
+	Clock::time_point lastFrameTime = Clock::now();
+
+	while (!_isStopRequested) {
+		if (_headlessSettings.maxFrames > 0 && _currentFrame >= _headlessSettings.maxFrames) {
+			break;
+		}
+
+		applyMouseInputs();
+
+		const Clock::time_point frameStart = Clock::now();
+		if (_headlessSettings.fixedDeltaTime <= 0.0f) {
+			_lastFrameSeconds = std::chrono::duration<float>(frameStart - lastFrameTime).count();
+		}
+		lastFrameTime = frameStart;
+
+		_frameCommands.clear();
+		_frameYOffsets.clear();
+
+		callUpdate(updater, _lastFrameSeconds);
+
+		_frameStats.updateSeconds += std::chrono::duration<double>(Clock::now() - frameStart).count();
+		_frameStats.simulatedSeconds += _lastFrameSeconds;
+		_frameStats.numFrames++;
+
+		// Keeps both buffers' capacity, the swap avoids copying the commands
+		_lastFrameCommands.swap(_frameCommands);
+		_lastFrameYOffsets.swap(_frameYOffsets);
+
+		_currentFrame++;
+	}
+
+	_updater.reset();
+}
+
+void Engine::stop()
+{
+	_isStopRequested = true;
+}
+
+Engine::Point2D Engine::getMousePosition() const
+{
+	return _mousePosition;
+}
+
+bool Engine::isMouseButtonDown() const
+{
+	return _isMouseButtonDown;
+}
+
+Engine::Size Engine::getScreenSize() const
+{
+	return _windowSize;
+}
+
+float Engine::getElapsedTime() const
+{
+	return _lastFrameSeconds;
+}
+
+#pragma region - Texture handling
+std::string Engine::getFullPathFromAssetName(const std::string& assetName) const
+{
+	return std::filesystem::path(_assetsDirectoryPath + assetName).lexically_normal().generic_string();
+}
+
+Engine::TextureId Engine::registerTexture(const std::string& assetPath, bool keepCpuCopy)
+{
+	const std::string assetFullPath = getFullPathFromAssetName(assetPath);
+
+	auto assetTextureIdIter = _textureMapByAssetName.find(assetFullPath);
+	if (assetTextureIdIter != _textureMapByAssetName.end()) {
+		_textureCacheStats.hits++;
+
+		Texture& cached = _textureMapById.at(assetTextureIdIter->second);
+		cached.refCount++;
+		if (keepCpuCopy && cached.cpuCopy == nullptr) {
+			loadTexture(assetFullPath, true, cached);
+		}
+		return assetTextureIdIter->second;
+	}
+
+	_textureCacheStats.misses++;
+
+	Texture texture;
+	loadTexture(assetFullPath, keepCpuCopy, texture);
+	texture.assetKey = assetFullPath;
+	texture.refCount = 1;
+
+	_textureCacheStats.uploads++;
+
+	const TextureId textureId = _nextTextureId++;
+	_textureMapById.emplace(textureId, texture);
+	_textureMapByAssetName.emplace(assetFullPath, textureId);
+
+	return textureId;
+}
+
+void Engine::loadTexture(const std::string& assetFullPath, bool keepCpuCopy, Texture& texture) const
+{
+	// Without a GPU the decoded image is the resident copy, so DecodeToCpu always keeps it
+	const bool keepDecoded = keepCpuCopy || _headlessSettings.textureLoadMode == TextureLoadMode::DecodeToCpu;
+
+	int width = 0;
+	int height = 0;
+	if (!keepDecoded && SDL::TextureLoader::ReadImageSize(assetFullPath, width, height)) {
+		texture.size = Size(width, height);
+		return;
+	}
+
+	SDL_Surface* decoded = IMG_Load(assetFullPath.c_str());
+	if (decoded == nullptr) {
+		throw std::runtime_error(std::string("Unable to load texture ") + assetFullPath);
+	}
+
+	texture.size = Size(decoded->w, decoded->h);
+	texture.pixelFormat = decoded->format->format;
+
+	if (keepDecoded) {
+		texture.cpuCopy = decoded;
+	}
+	else {
+		SDL_FreeSurface(decoded);
+	}
+}
+
+size_t Engine::getSurfaceBytes(const SDL_Surface* surface) const
+{
+	return surface != nullptr ? static_cast<size_t>(surface->pitch) * surface->h : 0;
+}
+
+bool Engine::isTextureResident(TextureId textureId) const
+{
+	assert(_textureMapById.find(textureId) != _textureMapById.end());
+
+	// Loading is synchronous, a registered texture is always resident
+	return true;
+}
+
+std::vector<Engine::TextureId> Engine::preloadTextures(const std::vector<std::string>& assetPaths)
+{
+	std::vector<TextureId> textureIds;
+	textureIds.reserve(assetPaths.size());
+
+	for (const std::string& assetPath : assetPaths) {
+		textureIds.push_back(registerTexture(assetPath));
+	}
+	return textureIds;
+}
+
+void Engine::waitForPendingTextures()
+{
+	// Empty on purpose
+}
+
+void Engine::releaseTexture(TextureId textureId)
+{
+	auto textureIter = _textureMapById.find(textureId);
+	assert(textureIter != _textureMapById.end());
+	assert(textureIter->second.refCount > 0);
+
+	textureIter->second.refCount--;
+	_textureCacheStats.releases++;
+}
+
+void Engine::purgeUnusedTextures()
+{
+	for (auto textureIter = _textureMapById.begin(); textureIter != _textureMapById.end(); ) {
+		Texture& texture = textureIter->second;
+		if (texture.refCount > 0) {
+			++textureIter;
+			continue;
+		}
+
+		if (texture.cpuCopy != nullptr) {
+			SDL_FreeSurface(texture.cpuCopy);
+		}
+		_textureMapByAssetName.erase(texture.assetKey);
+		textureIter = _textureMapById.erase(textureIter);
+
+		_textureCacheStats.purged++;
+	}
+}
+
+Engine::TextureCacheStats Engine::getTextureCacheStats() const
+{
+	TextureCacheStats stats = _textureCacheStats;
+	stats.residentTextures = static_cast<uint32_t>(_textureMapById.size());
+	return stats;
+}
+
+Engine::TextureInfo Engine::getTextureInfo(TextureId textureId) const
+{
+	auto textureIter = _textureMapById.find(textureId);
+	assert(textureIter != _textureMapById.end());
+
+	const Texture& texture = textureIter->second;
+
+	TextureInfo info;
+	info.size = texture.size;
+	info.pixelFormat = texture.pixelFormat;
+	info.cpuBytes = getSurfaceBytes(texture.cpuCopy);
+	return info;
+}
+
+Engine::TextureMemoryStats Engine::getTextureMemoryStats() const
+{
+	TextureMemoryStats stats;
+	for (const auto& textureIter : _textureMapById) {
+		stats.cpuBytes += getSurfaceBytes(textureIter.second.cpuCopy);
+	}
+	return stats;
+}
+
+Engine::Size Engine::getTextureSize(TextureId textureId) const
+{
+	auto textureIter = _textureMapById.find(textureId);
+	assert(textureIter != _textureMapById.end());
+
+	return textureIter->second.size;
+}
+
+#pragma region - Text/font handling
+Engine::FontId Engine::registerFont(const std::string& descriptorAssetPath)
+{
+	SDL::Font font = SDL::Font::LoadFromBMFont(getFullPathFromAssetName(descriptorAssetPath));
+
+	const std::filesystem::path descriptorDirectory = std::filesystem::path(descriptorAssetPath).parent_path();
+	const std::string pageAssetPath = (descriptorDirectory / font.getPageFileName()).generic_string();
+
+	return addFont(std::move(font), pageAssetPath);
+}
+
+Engine::FontId Engine::addFont(SDL::Font&& font, const std::string& pageAssetPath)
+{
+	const TextureId textureId = registerTexture(pageAssetPath);
+	_fonts.push_back(FontEntry{ std::move(font), textureId });
+
+	return static_cast<FontId>(_fonts.size() - 1);
+}
+
+const Engine::FontEntry& Engine::getFont(FontId fontId) const
+{
+	assert(fontId < _fonts.size());
+	return _fonts[fontId];
+}
+
+Engine::Size2D Engine::measureText(const std::string& text, FontId fontId) const
+{
+	using namespace HeadlessEngineConstants;
+
+	const SDL::Font& font = getFont(fontId).font;
+
+	int maxHeight = 0;
+	int advance = 0;
+	for (char character : text) {
+		const SDL::Glyph& g = font.getGlyph(character);
+		advance += g.advance + InterLetterAdvance;
+		maxHeight = std::max(maxHeight, g.height);
+	}
+	return Size2D(advance, maxHeight);
+}
+
+Engine::Size2D Engine::getTextSize(const std::string& text, float scale, FontId fontId) const
+{
+	return measureText(text, fontId) * scale;
+}
+
+float Engine::getCharacterAdvance(char character, float scale, FontId fontId) const
+{
+	using namespace HeadlessEngineConstants;
+
+	const SDL::Glyph& g = getFont(fontId).font.getGlyph(character);
+	return static_cast<float>(g.advance + InterLetterAdvance) * scale;
+}
+
+Engine::TextLayoutId Engine::createTextLayout(const std::string& text, FontId fontId)
+{
+	TextLayoutId layoutId;
+	if (_freeTextLayoutIds.empty()) {
+		layoutId = static_cast<TextLayoutId>(_textLayouts.size());
+		_textLayouts.emplace_back();
+	}
+	else {
+		layoutId = _freeTextLayoutIds.back();
+		_freeTextLayoutIds.pop_back();
+	}
+
+	TextLayout& layout = _textLayouts[layoutId];
+	layout.fontId = fontId;
+	layout.text = text;
+	layout.size = measureText(text, fontId);
+	layout.isInUse = true;
+
+	return layoutId;
+}
+
+void Engine::updateTextLayout(TextLayoutId layoutId, const std::string& text)
+{
+	assert(layoutId < _textLayouts.size() && _textLayouts[layoutId].isInUse);
+
+	TextLayout& layout = _textLayouts[layoutId];
+	if (layout.text != text) {
+		layout.text = text;
+		layout.size = measureText(text, layout.fontId);
+	}
+}
+
+void Engine::releaseTextLayout(TextLayoutId layoutId)
+{
+	assert(layoutId < _textLayouts.size() && _textLayouts[layoutId].isInUse);
+
+	// Nothing is drawn later in the frame, so the slot can be recycled straight away
+	_textLayouts[layoutId].isInUse = false;
+	_freeTextLayoutIds.push_back(layoutId);
+}
+
+Engine::Size2D Engine::getTextLayoutSize(TextLayoutId layoutId, float scale) const
+{
+	assert(layoutId < _textLayouts.size());
+	return _textLayouts[layoutId].size * scale;
+}
+
+#pragma region - Rendering
+void Engine::render(TextureId textureId, const Point2D& position, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
+{
+	assert(_textureMapById.find(textureId) != _textureMapById.end());
+
+	recordCommand({ CommandType::Sprite, zIndex, textureId, DefaultFontId, InvalidTextLayoutId, 0, position, color, rotation, scale, opacity }, HeadlessEngineConstants::NoYOffsets);
+}
+
+void Engine::renderText(const std::string& text, const Point2D& position, int zIndex, const Color3D& color, float rotation, float scale, float opacity, FontId fontId)
+{
+	renderText(text, position, HeadlessEngineConstants::NoYOffsets, zIndex, color, rotation, scale, opacity, fontId);
+}
+
+void Engine::renderText(const std::string& text, const Point2D& position, const std::vector<float>& yPositions, int zIndex, const Color3D& color, float rotation, float scale, float opacity, FontId fontId)
+{
+	assert(yPositions.empty() || yPositions.size() >= text.size());
+
+	recordCommand({ CommandType::Text, zIndex, getFont(fontId).textureId, fontId, InvalidTextLayoutId, static_cast<uint32_t>(text.size()), position, color, rotation, scale, opacity }, yPositions);
+}
+
+void Engine::renderTextLayout(TextLayoutId layoutId, const Point2D& position, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
+{
+	renderTextLayout(layoutId, position, HeadlessEngineConstants::NoYOffsets, zIndex, color, rotation, scale, opacity);
+}
+
+void Engine::renderTextLayout(TextLayoutId layoutId, const Point2D& position, const std::vector<float>& yOffsets, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
+{
+	assert(layoutId < _textLayouts.size() && _textLayouts[layoutId].isInUse);
+
+	const TextLayout& layout = _textLayouts[layoutId];
+	assert(yOffsets.empty() || yOffsets.size() >= layout.text.size());
+
+	recordCommand({ CommandType::TextLayout, zIndex, getFont(layout.fontId).textureId, layout.fontId, layoutId, static_cast<uint32_t>(layout.text.size()), position, color, rotation, scale, opacity }, yOffsets);
+}
+
+void Engine::beginParallelSubmit(size_t numStreams)
+{
+	assert(_numSubmitStreams == 0);
+
+	if (_submitStreams.size() < numStreams) {
+		_submitStreams.resize(numStreams);
+	}
+	_numSubmitStreams = numStreams;
+}
+
+void Engine::endParallelSubmit()
+{
+	const size_t numStreams = _numSubmitStreams;
+	_numSubmitStreams = 0;
+
+	for (size_t i = 0; i < numStreams; ++i) {
+		SubmitStream& stream = _submitStreams[i];
+
+		// Arena offsets were taken inside the stream, rebase them onto the frame arena
+		const uint32_t yOffsetBase = static_cast<uint32_t>(_frameYOffsets.size());
+		_frameYOffsets.insert(_frameYOffsets.end(), stream.yOffsetArena.begin(), stream.yOffsetArena.end());
+
+		for (RecordedCommand& command : stream.commands) {
+			command.yOffsetsOffset += yOffsetBase;
+			addFrameCommand(command);
+		}
+
+		stream.commands.clear();
+		stream.yOffsetArena.clear();
+	}
+}
+
+void Engine::recordCommand(RecordedCommand command, const std::vector<float>& yOffsets)
+{
+	// Parallel jobs record into their own stream, endParallelSubmit appends them in order
+	const size_t stream = GetCurrentSubmitStream();
+	std::vector<float>& yOffsetArena = stream != MainSubmitStream ? _submitStreams[stream].yOffsetArena : _frameYOffsets;
+	assert(stream == MainSubmitStream || stream < _numSubmitStreams);
+
+	command.yOffsetsOffset = static_cast<uint32_t>(yOffsetArena.size());
+	command.numYOffsets = static_cast<uint32_t>(yOffsets.size());
+	yOffsetArena.insert(yOffsetArena.end(), yOffsets.begin(), yOffsets.end());
+
+	if (stream != MainSubmitStream) {
+		_submitStreams[stream].commands.push_back(command);
+		return;
+	}
+
+	addFrameCommand(command);
+}
+
+void Engine::addFrameCommand(const RecordedCommand& command)
+{
+	switch (command.type) {
+		case CommandType::Sprite:
+			_frameStats.numSpriteCommands++;
+			break;
+		case CommandType::Text:
+			_frameStats.numTextCommands++;
+			break;
+		case CommandType::TextLayout:
+			_frameStats.numTextLayoutCommands++;
+			break;
+	}
+
+	_frameCommands.push_back(command);
+}
+
+#pragma region - Headless specific
+void Engine::addMouseInput(const MouseInput& input)
+{
+	auto insertPosition = std::upper_bound(_mouseInputs.begin() + _nextMouseInput, _mouseInputs.end(), input,
+		[](const MouseInput& lhs, const MouseInput& rhs) { return lhs.frame < rhs.frame; });
+
+	_mouseInputs.insert(insertPosition, input);
+}
+
+void Engine::applyMouseInputs()
+{
+	while (_nextMouseInput < _mouseInputs.size() && _mouseInputs[_nextMouseInput].frame <= _currentFrame) {
+		const MouseInput& input = _mouseInputs[_nextMouseInput++];
+
+		_mousePosition = input.position;
+		_isMouseButtonDown = input.isButtonDown;
+	}
+}
+
+const std::vector<Engine::RecordedCommand>& Engine::getLastFrameCommands() const
+{
+	return _lastFrameCommands;
+}
+
+const std::vector<float>& Engine::getLastFrameYOffsets() const
+{
+	return _lastFrameYOffsets;
+}
+
+const Engine::FrameStats& Engine::getFrameStats() const
+{
+	return _frameStats;
+}
+
+void Engine::resetFrameStats()
+{
+	_frameStats = FrameStats();
+}
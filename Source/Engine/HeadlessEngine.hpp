@@ -0,0 +1,217 @@
+//
+// HeadlessEngine.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+
+#include "Framework/Core/Engine.hpp"
+#include "Framework/Core/Types.hpp"
+#include "SDLFont.hpp"
+
+struct SDL_Surface;
+
+namespace Headless
+{
+	class Engine;
+	using EngineOwner = std::shared_ptr<Engine>;
+
+	enum class TextureLoadMode
+	{
+		MetadataOnly,	// Only the image size is read, from the PNG header when possible
+		DecodeToCpu,	// Images are fully decoded and kept in system memory
+	};
+
+	struct HeadlessSettings
+	{
+		TextureLoadMode textureLoadMode = TextureLoadMode::MetadataOnly;
+		float fixedDeltaTime = 1.0f / 60.0f;	// Zero runs as fast as possible with the measured frame time
+		uint32_t maxFrames = 0;					// Zero runs until stop() is called
+	};
+
+	//
+	// Engine without window, GL context or audio. Render calls are recorded instead of drawn and
+	// mouse input is scripted, so the game loop can be measured on machines without a GPU
+	//
+	class Engine final : public Framework::Core::Engine
+	{
+	public:
+		struct MouseInput
+		{
+			uint32_t frame = 0;
+			Point2D position;
+			bool isButtonDown = false;
+		};
+
+		enum class CommandType
+		{
+			Sprite,
+			Text,
+			TextLayout,
+		};
+
+		struct RecordedCommand
+		{
+			CommandType type;
+			int zIndex;
+			TextureId textureId;
+			FontId fontId;
+			TextLayoutId textLayoutId;
+			uint32_t textLength;
+			Point2D position;
+			Color3D color;
+			float rotation;
+			float scale;
+			float opacity;
+			// Into getLastFrameYOffsets(), set when the command is recorded
+			uint32_t yOffsetsOffset = 0;
+			uint32_t numYOffsets = 0;
+		};
+
+		struct FrameStats
+		{
+			uint32_t numFrames = 0;
+			uint64_t numSpriteCommands = 0;
+			uint64_t numTextCommands = 0;
+			uint64_t numTextLayoutCommands = 0;
+			double updateSeconds = 0.0;		// Wall time spent in the game object tree, render submission included
+			double simulatedSeconds = 0.0;
+		};
+
+		static EngineOwner Create(const Settings& settings, const HeadlessSettings& headlessSettings = HeadlessSettings());
+
+		~Engine() override;
+
+		void start(Framework::Types::GameObject::PtrType updater) override;
+		void stop() override;
+
+		Point2D getMousePosition() const override;
+		bool isMouseButtonDown() const override;
+		Size getScreenSize() const override;
+		float getElapsedTime() const override;
+
+		TextureId registerTexture(const std::string& assetPath, bool keepCpuCopy = false) override;
+		bool isTextureResident(TextureId textureId) const override;
+		std::vector<TextureId> preloadTextures(const std::vector<std::string>& assetPaths) override;
+		void waitForPendingTextures() override;
+		void releaseTexture(TextureId textureId) override;
+		void purgeUnusedTextures() override;
+		TextureCacheStats getTextureCacheStats() const override;
+		TextureInfo getTextureInfo(TextureId textureId) const override;
+		TextureMemoryStats getTextureMemoryStats() const override;
+		Size getTextureSize(TextureId textureId) const override;
+
+		FontId registerFont(const std::string& descriptorAssetPath) override;
+		Size2D getTextSize(const std::string& text, float scale, FontId fontId = DefaultFontId) const override;
+		float getCharacterAdvance(char character, float scale = 1.0f, FontId fontId = DefaultFontId) const override;
+
+		void render(TextureId textureId, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) override;
+		void renderText(const std::string& text, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f, FontId fontId = DefaultFontId) override;
+		void renderText(const std::string& text, const Point2D& position, const std::vector<float>& yPositions, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f, FontId fontId = DefaultFontId) override;
+
+		TextLayoutId createTextLayout(const std::string& text, FontId fontId = DefaultFontId) override;
+		void updateTextLayout(TextLayoutId layoutId, const std::string& text) override;
+		void releaseTextLayout(TextLayoutId layoutId) override;
+		Size2D getTextLayoutSize(TextLayoutId layoutId, float scale = 1.0f) const override;
+		void renderTextLayout(TextLayoutId layoutId, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) override;
+		void renderTextLayout(TextLayoutId layoutId, const Point2D& position, const std::vector<float>& yOffsets, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) override;
+
+		void beginParallelSubmit(size_t numStreams) override;
+		void endParallelSubmit() override;
+
+#pragma region - Headless specific
+		// Inputs are applied at the start of their frame, in the order they were added
+		void addMouseInput(const MouseInput& input);
+
+		const std::vector<RecordedCommand>& getLastFrameCommands() const;
+		// Per glyph y offsets of the last frame text commands, as the SDL queue keeps them
+		const std::vector<float>& getLastFrameYOffsets() const;
+		const FrameStats& getFrameStats() const;
+		void resetFrameStats();
+
+	protected:
+		Engine(const Settings& settings, const HeadlessSettings& headlessSettings);
+
+	private:
+#pragma region - Texture handling
+		struct Texture
+		{
+			Size size;
+			uint32_t pixelFormat = 0;
+			SDL_Surface* cpuCopy = nullptr;
+			std::string assetKey;
+			uint32_t refCount = 0;
+		};
+
+		void loadTexture(const std::string& assetFullPath, bool keepCpuCopy, Texture& texture) const;
+		size_t getSurfaceBytes(const SDL_Surface* surface) const;
+		std::string getFullPathFromAssetName(const std::string& assetName) const;
+
+#pragma region - Text/font handling
+		struct FontEntry
+		{
+			SDL::Font font;
+			TextureId textureId;
+		};
+
+		struct TextLayout
+		{
+			FontId fontId = DefaultFontId;
+			std::string text;
+			Size2D size;
+			bool isInUse = false;
+		};
+
+		FontId addFont(SDL::Font&& font, const std::string& pageAssetPath);
+		const FontEntry& getFont(FontId fontId) const;
+		Size2D measureText(const std::string& text, FontId fontId) const;
+
+#pragma region - Frame handling
+		void applyMouseInputs();
+		// Commands of one parallel job, with offsets into its own arena until they are merged
+		struct SubmitStream
+		{
+			std::vector<RecordedCommand> commands;
+			std::vector<float> yOffsetArena;
+		};
+
+		void recordCommand(RecordedCommand command, const std::vector<float>& yOffsets);
+		void addFrameCommand(const RecordedCommand& command);
+
+		HeadlessSettings _headlessSettings;
+		std::string _assetsDirectoryPath;
+		Size _windowSize;
+
+		TextureId _nextTextureId = 1;
+		std::unordered_map<TextureId, Texture> _textureMapById;
+		std::unordered_map<std::string, TextureId> _textureMapByAssetName;
+		TextureCacheStats _textureCacheStats;
+
+		std::vector<FontEntry> _fonts;
+		std::vector<TextLayout> _textLayouts;
+		std::vector<TextLayoutId> _freeTextLayoutIds;
+
+		std::vector<MouseInput> _mouseInputs;
+		size_t _nextMouseInput = 0;
+		Point2D _mousePosition;
+		bool _isMouseButtonDown = false;
+
+		std::vector<RecordedCommand> _frameCommands;
+		std::vector<RecordedCommand> _lastFrameCommands;
+		std::vector<float> _frameYOffsets;
+		std::vector<float> _lastFrameYOffsets;
+		std::vector<SubmitStream> _submitStreams;	// Kept between frames so their storage is reused
+		size_t _numSubmitStreams = 0;
+		FrameStats _frameStats;
+
+		Framework::Types::GameObject::PtrType _updater;
+		bool _isStopRequested = false;
+		uint32_t _currentFrame = 0;
+		float _lastFrameSeconds = 0.0f;
+	};
+}
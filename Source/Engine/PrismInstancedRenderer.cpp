@@ -0,0 +1,231 @@
+//
+// PrismInstancedRenderer.cpp
+//
+// @author Roberto Cano
+//
+
+#include "PrismInstancedRenderer.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <cstddef>
+
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/matrix_transform.hpp>
+#include <glew/glew.h>
+
+using namespace Prism;
+
+namespace InstancedRendererConstants
+{
+	const size_t InitialInstanceCapacity = 4096;
+	const GLsizei VerticesPerQuad = 4;
+
+	enum AttributeLocation : GLuint
+	{
+		Position = 0,
+		Offset,
+		HalfSize,
+		RotationScale,
+		UvRect,
+		Color,
+		NumAttributes
+	};
+
+	// The quad corner comes from gl_VertexID, so there is no per-vertex buffer at all
+	const char* VertexShaderSource = R"(#version 330 core
+layout(location = 0) in vec2 aPosition;
+layout(location = 1) in vec2 aOffset;
+layout(location = 2) in vec2 aHalfSize;
+layout(location = 3) in vec2 aRotationScale;
+layout(location = 4) in vec4 aUvRect;
+layout(location = 5) in vec4 aColor;
+
+uniform mat4 uProjection;
+
+out vec2 vUv;
+out vec4 vColor;
+
+void main()
+{
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+	vec2 local = (aOffset + (corner * 2.0 - 1.0) * aHalfSize) * aRotationScale.y;
+
+	float sine = sin(aRotationScale.x);
+	float cosine = cos(aRotationScale.x);
+	vec2 world = aPosition + vec2(cosine * local.x - sine * local.y, sine * local.x + cosine * local.y);
+
+	gl_Position = uProjection * vec4(world, 0.0, 1.0);
+	vUv = mix(aUvRect.xy, aUvRect.zw, corner);
+	vColor = aColor;
+}
+)";
+
+	// Same result as the fixed-function GL_MODULATE texture environment
+	const char* FragmentShaderSource = R"(#version 330 core
+in vec2 vUv;
+in vec4 vColor;
+
+uniform sampler2D uTexture;
+
+out vec4 fragColor;
+
+void main()
+{
+	fragColor = texture(uTexture, vUv) * vColor;
+}
+)";
+}
+
+InstancedRenderer::InstancedRenderer(const Framework::Types::Size& viewportSize)
+{
+	using namespace InstancedRendererConstants;
+
+	createProgram();
+
+	const glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(viewportSize.width), static_cast<float>(viewportSize.height), 0.0f, -1.0f, 1.0f);
+
+	// The program is the only one ever used, it stays bound with its uniforms set once
+	glUseProgram(_programId);
+	glUniformMatrix4fv(glGetUniformLocation(_programId, "uProjection"), 1, GL_FALSE, &projection[0][0]);
+	glUniform1i(glGetUniformLocation(_programId, "uTexture"), 0);
+
+	createInstanceBuffer();
+
+	_instances.reserve(InitialInstanceCapacity);
+}
+
+InstancedRenderer::~InstancedRenderer()
+{
+	glDeleteBuffers(1, &_instanceBufferId);
+	glDeleteVertexArrays(1, &_vertexArrayId);
+	glDeleteProgram(_programId);
+}
+
+void InstancedRenderer::push(uint32_t pageTextureId, const SDL::QuadInstance& instance)
+{
+	if (_batches.empty() || _batches.back().pageTextureId != pageTextureId) {
+		_batches.push_back({ pageTextureId, static_cast<uint32_t>(_instances.size()), 0 });
+	}
+
+	_instances.push_back(instance);
+	_batches.back().numInstances++;
+}
+
+void InstancedRenderer::flush()
+{
+	using namespace InstancedRendererConstants;
+
+	if (_instances.empty()) {
+		return;
+	}
+
+	uploadInstances();
+
+	// Core 3.3 has no base instance, so the attribute pointers are moved to the start of each batch instead
+	for (const Batch& batch : _batches) {
+		glBindTexture(GL_TEXTURE_2D, batch.pageTextureId);
+		setInstanceAttributes(batch.firstInstance);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, VerticesPerQuad, static_cast<GLsizei>(batch.numInstances));
+	}
+
+	_instances.clear();
+	_batches.clear();
+}
+
+uint32_t InstancedRenderer::compileShader(uint32_t shaderType, const char* source) const
+{
+	const GLuint shaderId = glCreateShader(shaderType);
+	glShaderSource(shaderId, 1, &source, nullptr);
+	glCompileShader(shaderId);
+
+	GLint isCompiled = GL_FALSE;
+	glGetShaderiv(shaderId, GL_COMPILE_STATUS, &isCompiled);
+	if (isCompiled != GL_TRUE) {
+		GLint logLength = 0;
+		glGetShaderiv(shaderId, GL_INFO_LOG_LENGTH, &logLength);
+
+		std::string log(static_cast<size_t>(logLength), '\0');
+		glGetShaderInfoLog(shaderId, logLength, nullptr, &log[0]);
+		glDeleteShader(shaderId);
+
+		throw std::runtime_error(std::string("Error compiling shader: ") + log);
+	}
+
+	return shaderId;
+}
+
+void InstancedRenderer::createProgram()
+{
+	using namespace InstancedRendererConstants;
+
+	const GLuint vertexShaderId = compileShader(GL_VERTEX_SHADER, VertexShaderSource);
+	const GLuint fragmentShaderId = compileShader(GL_FRAGMENT_SHADER, FragmentShaderSource);
+
+	_programId = glCreateProgram();
+	glAttachShader(_programId, vertexShaderId);
+	glAttachShader(_programId, fragmentShaderId);
+	glLinkProgram(_programId);
+
+	// The program keeps what it needs once linked
+	glDeleteShader(vertexShaderId);
+	glDeleteShader(fragmentShaderId);
+
+	GLint isLinked = GL_FALSE;
+	glGetProgramiv(_programId, GL_LINK_STATUS, &isLinked);
+	if (isLinked != GL_TRUE) {
+		GLint logLength = 0;
+		glGetProgramiv(_programId, GL_INFO_LOG_LENGTH, &logLength);
+
+		std::string log(static_cast<size_t>(logLength), '\0');
+		glGetProgramInfoLog(_programId, logLength, nullptr, &log[0]);
+
+		throw std::runtime_error(std::string("Error linking shader program: ") + log);
+	}
+}
+
+void InstancedRenderer::createInstanceBuffer()
+{
+	using namespace InstancedRendererConstants;
+
+	glGenVertexArrays(1, &_vertexArrayId);
+	glBindVertexArray(_vertexArrayId);
+
+	glGenBuffers(1, &_instanceBufferId);
+	glBindBuffer(GL_ARRAY_BUFFER, _instanceBufferId);
+
+	_instanceBufferCapacity = InitialInstanceCapacity;
+	glBufferData(GL_ARRAY_BUFFER, _instanceBufferCapacity * sizeof(SDL::QuadInstance), nullptr, GL_STREAM_DRAW);
+
+	// Every attribute advances once per instance, the vertex array and the buffer stay bound from here on
+	for (GLuint location = 0; location < NumAttributes; ++location) {
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
+}
+
+void InstancedRenderer::setInstanceAttributes(uint32_t firstInstance) const
+{
+	using namespace InstancedRendererConstants;
+
+	const GLsizei stride = sizeof(SDL::QuadInstance);
+	const size_t base = static_cast<size_t>(firstInstance) * stride;
+
+	glVertexAttribPointer(Position, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(base + offsetof(SDL::QuadInstance, position)));
+	glVertexAttribPointer(Offset, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(base + offsetof(SDL::QuadInstance, offset)));
+	glVertexAttribPointer(HalfSize, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(base + offsetof(SDL::QuadInstance, halfSize)));
+	glVertexAttribPointer(RotationScale, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(base + offsetof(SDL::QuadInstance, rotation)));
+	glVertexAttribPointer(UvRect, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, reinterpret_cast<const void*>(base + offsetof(SDL::QuadInstance, uvRect)));
+	glVertexAttribPointer(Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<const void*>(base + offsetof(SDL::QuadInstance, color)));
+}
+
+void InstancedRenderer::uploadInstances()
+{
+	while (_instanceBufferCapacity < _instances.size()) {
+		_instanceBufferCapacity *= 2;
+	}
+
+	// Orphan the previous storage so the driver does not stall waiting for the last frame to finish
+	glBufferData(GL_ARRAY_BUFFER, _instanceBufferCapacity * sizeof(SDL::QuadInstance), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, _instances.size() * sizeof(SDL::QuadInstance), _instances.data());
+}
@@ -0,0 +1,55 @@
+//
+// PrismInstancedRenderer.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+
+#include "Framework/Core/Types.hpp"
+#include "SDLQuadRenderer.hpp"
+
+namespace Prism
+{
+	//
+	// Programmable pipeline backend, needs a GL 3.3 core context. Every quad is one instance
+	// record, the whole frame is uploaded with a single buffer update and the vertex shader
+	// expands each instance into a quad. One instanced draw call per run of quads on the same page
+	//
+	class InstancedRenderer final : public SDL::QuadRenderer
+	{
+	public:
+		explicit InstancedRenderer(const Framework::Types::Size& viewportSize);
+		~InstancedRenderer() override;
+
+		InstancedRenderer(const InstancedRenderer&) = delete;
+		InstancedRenderer& operator=(const InstancedRenderer&) = delete;
+
+		void push(uint32_t pageTextureId, const SDL::QuadInstance& instance) override;
+		void flush() override;
+
+	private:
+		struct Batch
+		{
+			uint32_t pageTextureId;
+			uint32_t firstInstance;
+			uint32_t numInstances;
+		};
+
+		uint32_t compileShader(uint32_t shaderType, const char* source) const;
+		void createProgram();
+		void createInstanceBuffer();
+		void setInstanceAttributes(uint32_t firstInstance) const;
+		void uploadInstances();
+
+		std::vector<SDL::QuadInstance> _instances;
+		std::vector<Batch> _batches;
+
+		uint32_t _programId = 0;
+		uint32_t _vertexArrayId = 0;
+		uint32_t _instanceBufferId = 0;
+		size_t _instanceBufferCapacity = 0;
+	};
+}
@@ -0,0 +1,108 @@
+//
+// SDLBatchRenderer.cpp
+//
+// @author Roberto Cano
+//
+
+#include "SDLBatchRenderer.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+#include <glew/glew.h>
+
+using namespace SDL;
+
+namespace BatchRendererConstants
+{
+	const size_t VerticesPerQuad = 4;
+	const size_t IndicesPerQuad = 6;
+
+	// Bottom-left, bottom-right, top-right, top-left, in the order the index pattern expects
+	const glm::vec2 QuadCorners[VerticesPerQuad] = { { 0.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, 0.0f }, { 0.0f, 0.0f } };
+}
+
+BatchRenderer::BatchRenderer(const Framework::Types::Size& viewportSize)
+{
+	using namespace BatchRendererConstants;
+
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(0.0f, viewportSize.width, viewportSize.height, 0.0f, -1.0f, 1.0f);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	// The index pattern never changes, so it is uploaded once and every batch reuses it
+	std::vector<GLushort> indices;
+	indices.reserve(MaxBatchQuads * IndicesPerQuad);
+	for (size_t quad = 0; quad < MaxBatchQuads; ++quad) {
+		const GLushort first = static_cast<GLushort>(quad * VerticesPerQuad);
+		indices.insert(indices.end(), { first, static_cast<GLushort>(first + 1), static_cast<GLushort>(first + 2),
+			first, static_cast<GLushort>(first + 2), static_cast<GLushort>(first + 3) });
+	}
+
+	GLuint buffers[2];
+	glGenBuffers(2, buffers);
+	_vertexBufferId = buffers[0];
+	_indexBufferId = buffers[1];
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferId);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ARRAY_BUFFER, _vertexBufferId);
+	glBufferData(GL_ARRAY_BUFFER, MaxBatchQuads * VerticesPerQuad * sizeof(BatchVertex), nullptr, GL_STREAM_DRAW);
+
+	// Both buffers stay bound for the whole lifetime of the engine, nothing else touches them
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(BatchVertex), reinterpret_cast<const void*>(offsetof(BatchVertex, x)));
+	glTexCoordPointer(2, GL_FLOAT, sizeof(BatchVertex), reinterpret_cast<const void*>(offsetof(BatchVertex, u)));
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(BatchVertex), reinterpret_cast<const void*>(offsetof(BatchVertex, color)));
+
+	_batchVertices.reserve(MaxBatchQuads * VerticesPerQuad);
+}
+
+void BatchRenderer::push(uint32_t pageTextureId, const QuadInstance& instance)
+{
+	using namespace BatchRendererConstants;
+
+	// Blending is the same straight alpha for every command, so the texture is the only state that breaks a batch
+	if (pageTextureId != _batchTextureId || _batchVertices.size() == MaxBatchQuads * VerticesPerQuad) {
+		flush();
+		_batchTextureId = pageTextureId;
+	}
+
+	const float sine = std::sin(instance.rotation);
+	const float cosine = std::cos(instance.rotation);
+	const glm::vec4 uvRect = instance.getUvRect();
+
+	// Same transform the instanced vertex shader applies: scale, rotate around the pivot, translate
+	for (const glm::vec2& corner : QuadCorners) {
+		const glm::vec2 local = (instance.offset + (corner * 2.0f - 1.0f) * instance.halfSize) * instance.scale;
+		const glm::vec2 world = instance.position + glm::vec2(cosine * local.x - sine * local.y, sine * local.x + cosine * local.y);
+		const glm::vec2 uv = glm::mix(glm::vec2(uvRect.x, uvRect.y), glm::vec2(uvRect.z, uvRect.w), corner);
+
+		_batchVertices.push_back({ world.x, world.y, uv.x, uv.y, instance.color });
+	}
+}
+
+void BatchRenderer::flush()
+{
+	using namespace BatchRendererConstants;
+
+	if (_batchVertices.empty()) {
+		return;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, _batchTextureId);
+
+	// Orphan the previous storage so the driver does not stall waiting for the last draw to finish
+	glBufferData(GL_ARRAY_BUFFER, MaxBatchQuads * VerticesPerQuad * sizeof(BatchVertex), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, _batchVertices.size() * sizeof(BatchVertex), _batchVertices.data());
+
+	const GLsizei numIndices = static_cast<GLsizei>(_batchVertices.size() / VerticesPerQuad * IndicesPerQuad);
+	glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_SHORT, nullptr);
+
+	_batchVertices.clear();
+}
@@ -0,0 +1,48 @@
+//
+// SDLBatchRenderer.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+
+#include "Framework/Core/Types.hpp"
+#include "SDLQuadRenderer.hpp"
+
+namespace SDL
+{
+	//
+	// Fixed-function backend. Quads are expanded to vertices on the CPU and streamed through
+	// a single vertex buffer, one draw call per run of quads on the same atlas page
+	//
+	class BatchRenderer final : public QuadRenderer
+	{
+	public:
+		explicit BatchRenderer(const Framework::Types::Size& viewportSize);
+
+		BatchRenderer(const BatchRenderer&) = delete;
+		BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+		void push(uint32_t pageTextureId, const QuadInstance& instance) override;
+		void flush() override;
+
+	private:
+		struct BatchVertex
+		{
+			float x;
+			float y;
+			float u;
+			float v;
+			uint32_t color;
+		};
+
+		static const size_t MaxBatchQuads = 2048;
+
+		std::vector<BatchVertex> _batchVertices;
+		uint32_t _batchTextureId = 0;
+		uint32_t _vertexBufferId = 0;
+		uint32_t _indexBufferId = 0;
+	};
+}
@@ -5,14 +5,17 @@
 //
 
 #include "SDLEngine.hpp"
+#include "SDLBatchRenderer.hpp"
+#include "PrismInstancedRenderer.hpp"
 
 #include "Framework/Core/GameObject.hpp"
 
 #include <stdexcept>
 #include <algorithm>
+#include <filesystem>
+#include <chrono>
 
 #define GLM_FORCE_RADIANS
-#include <glm/gtc/matrix_transform.hpp>
 #include <glew/glew.h>
 #include <glm/glm.hpp>
 
@@ -24,6 +27,20 @@ using namespace SDL;
 namespace SDLEngineConstants
 {
 	const float MaxFrameTicks = 300.0f;
+	const int AtlasPageSize = 2048;
+	const size_t SortKeyBytes = 8;
+	const uint64_t SortKeySequenceMask = (1ull << 28) - 1;
+	const int SortKeyMinZIndex = -32768;
+	const int SortKeyMaxZIndex = 32767;
+}
+
+namespace
+{
+	// A zero scale has always meant unscaled
+	float GetEffectiveScale(float scale)
+	{
+		return scale != 0.0f ? scale : 1.0f;
+	}
 }
 
 EngineOwner Engine::Create(const Settings& settings)
@@ -32,7 +49,10 @@ EngineOwner Engine::Create(const Settings& settings)
 }
 
 Engine::Engine(const Settings& settings)
-	: _assetsDirectoryPath(settings.assetsDirectoryPath)
+	: _atlas(SDLEngineConstants::AtlasPageSize)
+	, _textureLoader(settings.numTextureLoaderThreads, TextureAtlas::GetPixelFormat())
+	, _textureUploadBudgetSeconds(settings.textureUploadBudgetSeconds)
+	, _assetsDirectoryPath(settings.assetsDirectoryPath)
 	, _lastFrameSeconds(1.0f / 60.0f)
 	, _windowSize(settings.windowSize)
 	, _mousePosition(settings.windowSize.width * 0.5f, settings.windowSize.height * 0.5f)
@@ -45,6 +65,15 @@ Engine::Engine(const Settings& settings)
 		throw std::runtime_error("Failed to init SDL");
 	}
 
+	const bool isInstanced = settings.renderer == RendererType::Instanced;
+
+	// The context version is decided when the window is created
+	if (isInstanced) {
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	}
+
 	_window = SDL_CreateWindow("SDLEngine", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, _windowSize.width, _windowSize.height, SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL);
 	if (_window == nullptr) {
 		throw std::runtime_error(std::string("Error creating window: ") + SDL_GetError());
@@ -56,21 +85,51 @@ Engine::Engine(const Settings& settings)
 		throw std::runtime_error(std::string("Error initialising OpenGL context: ") + error);
 	}
 
+	// Core profiles do not list extensions the way GLEW expects, without this the 3.3 entry points stay null
+	glewExperimental = GL_TRUE;
+	GLenum glewError = glewInit();
+	if (glewError != GLEW_OK) {
+		throw std::runtime_error(std::string("Error initialising GLEW: ") + reinterpret_cast<const char*>(glewGetErrorString(glewError)));
+	}
+	// glewInit trips GL_INVALID_ENUM on core profiles, nothing is actually wrong
+	glGetError();
+
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 	SDL_GL_SetSwapInterval(1);
 
-	glEnable(GL_TEXTURE_2D);
 	glClearColor(0.0, 0.0, 0.0, 1.0);
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	glOrtho(0.0f, settings.windowSize.width, settings.windowSize.height, 0.0f, -1.0f, 1.0f);
-	glMatrixMode(GL_MODELVIEW);
+	if (isInstanced) {
+		_quadRenderer = std::make_unique<Prism::InstancedRenderer>(_windowSize);
+	}
+	else {
+		glEnable(GL_TEXTURE_2D);
+		_quadRenderer = std::make_unique<BatchRenderer>(_windowSize);
+	}
+
+	if (settings.fontDescriptorFileName.empty()) {
+		addFont(Font::CreateBuiltIn(settings.fontFileName), settings.fontFileName);
+	}
+	else {
+		registerFont(settings.fontDescriptorFileName);
+	}
+	waitForPendingTextures();
 
-	_fontSurfaceTextureId = registerTexture(settings.fontFileName);
+	createJobSystem(settings.numUpdateThreads);
+	seedRandom(settings.randomSeed);
+}
+
+Engine::~Engine()
+{
+	// The CPU copies are owned by the engine, textures still cached at shutdown take theirs along
+	for (auto& textureIter : _textureMapById) {
+		if (textureIter.second.cpuCopy != nullptr) {
+			destroyTexture(textureIter.second.cpuCopy);
+		}
+	}
 }
 
 void Engine::start(Framework::Types::GameObject::PtrType updater)
@@ -89,6 +148,7 @@ void Engine::start(Framework::Types::GameObject::PtrType updater)
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		handleMouseEvents();
+		processLoadedTextures(_textureUploadBudgetSeconds);
 
 		float currentTicks = static_cast<float>(SDL_GetTicks());
 		float lastFrameTicks = currentTicks - _elapsedTicks;
@@ -126,56 +186,225 @@ bool Engine::isMouseButtonDown() const
 
 std::string Engine::getFullPathFromAssetName(const std::string& assetName) const
 {
-	return _assetsDirectoryPath + assetName;
+	// Canonical form so that the same file always maps to the same cache entry
+	return std::filesystem::path(_assetsDirectoryPath + assetName).lexically_normal().generic_string();
 }
 
-Engine::TextureId Engine::registerTexture(const std::string& assetPath)
+Engine::TextureId Engine::registerTexture(const std::string& assetPath, bool keepCpuCopy)
 {
 	const std::string assetFullPath = getFullPathFromAssetName(assetPath);
 
 	std::optional<TextureId> textureIdOpt = findTextureByAsset(assetFullPath);
 	if (textureIdOpt != std::nullopt)
 	{
+		_textureCacheStats.hits++;
+
+		Texture& cached = _textureMapById.at(textureIdOpt.value());
+		cached.refCount++;
+		if (keepCpuCopy && cached.cpuCopy == nullptr)
+		{
+			if (cached.isResident)
+			{
+				cached.cpuCopy = loadSurface(assetFullPath);
+			}
+			cached.keepCpuCopy = true;
+		}
 		return textureIdOpt.value();
 	}
 
-	SDL_Surface* texture = IMG_Load(assetFullPath.c_str());
-	if (texture == nullptr) {
-		throw std::runtime_error(std::string("Unable to load texture ") + assetFullPath);
+	_textureCacheStats.misses++;
+
+	const TextureId textureId = _nextTextureId++;
+
+	Texture entry;
+	entry.assetKey = assetFullPath;
+	entry.refCount = 1;
+	entry.keepCpuCopy = keepCpuCopy;
+
+	int width = 0;
+	int height = 0;
+	if (TextureLoader::ReadImageSize(assetFullPath, width, height))
+	{
+		// Space is reserved now so the size and UVs are valid before the pixels arrive
+		entry.region = _atlas.allocate(width, height);
+		_textureMapById.emplace(textureId, entry);
+		_textureLoader.request(textureId, assetFullPath);
+	}
+	else
+	{
+		// No cheap way to know the size of anything but PNGs, decode it on the spot
+		TextureLoader::Result result = TextureLoader::Load(textureId, assetFullPath, TextureAtlas::GetPixelFormat());
+		if (!result.error.empty())
+		{
+			throw std::runtime_error(result.error);
+		}
+
+		entry.region = _atlas.allocate(result.surface->w, result.surface->h);
+		_textureMapById.emplace(textureId, entry);
+		completeTextureLoad(result);
 	}
 
-	GLuint textureId;
+	_textureMapByAssetName.emplace(assetFullPath, textureId);
 
-	glGenTextures(1, &textureId);
-	glBindTexture(GL_TEXTURE_2D, textureId);
-	int mode;
-	switch (texture->format->BytesPerPixel) {
-		case 4:
-			mode = GL_RGBA;
-			break;
-		case 3:
-			mode = GL_RGB;
-			break;
-		case 1:
-			mode = GL_LUMINANCE_ALPHA;
-			break;
-		default:
-			throw std::runtime_error("Image with unknown channel profile");
+	return textureId;
+}
+
+bool Engine::isTextureResident(TextureId textureId) const
+{
+	return getTexture(textureId).isResident;
+}
+
+std::vector<Engine::TextureId> Engine::preloadTextures(const std::vector<std::string>& assetPaths)
+{
+	std::vector<TextureId> textureIds;
+	textureIds.reserve(assetPaths.size());
+
+	for (const std::string& assetPath : assetPaths)
+	{
+		textureIds.push_back(registerTexture(assetPath));
+	}
+	waitForPendingTextures();
+
+	return textureIds;
+}
+
+void Engine::waitForPendingTextures()
+{
+	TextureLoader::Result result;
+	while (_textureLoader.waitPopResult(result))
+	{
+		completeTextureLoad(result);
+	}
+}
+
+void Engine::processLoadedTextures(float budgetSeconds)
+{
+	using Clock = std::chrono::steady_clock;
+
+	const Clock::time_point start = Clock::now();
+
+	TextureLoader::Result result;
+	while (_textureLoader.tryPopResult(result))
+	{
+		completeTextureLoad(result);
+
+		if (std::chrono::duration<float>(Clock::now() - start).count() >= budgetSeconds)
+		{
 			break;
+		}
+	}
+}
+
+void Engine::completeTextureLoad(TextureLoader::Result& result)
+{
+	if (!result.error.empty())
+	{
+		throw std::runtime_error(result.error);
+	}
+
+	// Textures still loading are never purged, the entry is always there
+	Texture& texture = _textureMapById.at(result.requestId);
+
+	_atlas.upload(texture.region, *result.surface);
+	texture.pixelFormat = result.sourcePixelFormat;
+	texture.isResident = true;
+
+	_textureCacheStats.uploads++;
+
+	// The atlas holds the only copy that rendering needs
+	if (texture.keepCpuCopy)
+	{
+		texture.cpuCopy = result.surface;
+	}
+	else
+	{
+		destroyTexture(result.surface);
+	}
+	result.surface = nullptr;
+}
+
+void Engine::releaseTexture(TextureId textureId)
+{
+	auto textureIter = _textureMapById.find(textureId);
+	assert(textureIter != _textureMapById.end());
+	assert(textureIter->second.refCount > 0);
+
+	textureIter->second.refCount--;
+	_textureCacheStats.releases++;
+}
+
+void Engine::purgeUnusedTextures()
+{
+	for (auto textureIter = _textureMapById.begin(); textureIter != _textureMapById.end(); )
+	{
+		Texture& texture = textureIter->second;
+		if (texture.refCount > 0 || !texture.isResident)
+		{
+			++textureIter;
+			continue;
+		}
+
+		_atlas.remove(texture.region);
+		if (texture.cpuCopy != nullptr)
+		{
+			destroyTexture(texture.cpuCopy);
+		}
+		_textureMapByAssetName.erase(texture.assetKey);
+		textureIter = _textureMapById.erase(textureIter);
+
+		_textureCacheStats.purged++;
+	}
+}
+
+Engine::TextureCacheStats Engine::getTextureCacheStats() const
+{
+	TextureCacheStats stats = _textureCacheStats;
+	stats.residentTextures = static_cast<uint32_t>(_textureMapById.size());
+	return stats;
+}
+
+Engine::TextureInfo Engine::getTextureInfo(TextureId textureId) const
+{
+	const Texture& texture = getTexture(textureId);
+
+	TextureInfo info;
+	info.glTextureId = texture.region.pageTextureId;
+	info.size = Size(texture.region.width, texture.region.height);
+	info.pixelFormat = texture.pixelFormat;
+	info.cpuBytes = getSurfaceBytes(texture.cpuCopy);
+	info.gpuBytes = TextureAtlas::GetRegionBytes(texture.region);
+	return info;
+}
+
+Engine::TextureMemoryStats Engine::getTextureMemoryStats() const
+{
+	TextureMemoryStats stats;
+	for (const auto& textureIter : _textureMapById)
+	{
+		stats.cpuBytes += getSurfaceBytes(textureIter.second.cpuCopy);
 	}
-	glTexImage2D(GL_TEXTURE_2D, 0, mode, texture->w, texture->h, 0, mode, GL_UNSIGNED_BYTE, texture->pixels);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	stats.gpuBytes = _atlas.getGpuBytes();
+	return stats;
+}
 
-	_textureMapById.emplace(textureId, texture);
+SDL_Surface* Engine::loadSurface(const std::string& assetFullPath) const
+{
+	SDL_Surface* surface = IMG_Load(assetFullPath.c_str());
+	if (surface == nullptr) {
+		throw std::runtime_error(std::string("Unable to load texture ") + assetFullPath);
+	}
+	return surface;
+}
 
-	return static_cast<TextureId>(textureId);
+size_t Engine::getSurfaceBytes(const SDL_Surface* surface) const
+{
+	return surface != nullptr ? static_cast<size_t>(surface->pitch) * surface->h : 0;
 }
 
 Engine::Size Engine::getTextureSize(TextureId textureId) const
 {
-	SDL_Surface& texture = getTexture(textureId);
-	return Size(texture.w, texture.h);
+	const Texture& texture = getTexture(textureId);
+	return Size(texture.region.width, texture.region.height);
 }
 
 Engine::Size Engine::getScreenSize() const
@@ -183,14 +412,43 @@ Engine::Size Engine::getScreenSize() const
 	return _windowSize;
 }
 
-Engine::Size2D Engine::getTextSize(const std::string& text, float scale) const
+Engine::FontId Engine::registerFont(const std::string& descriptorAssetPath)
 {
-	Size2D textSize;
+	Font font = Font::LoadFromBMFont(getFullPathFromAssetName(descriptorAssetPath));
+
+	const std::filesystem::path descriptorDirectory = std::filesystem::path(descriptorAssetPath).parent_path();
+	const std::string pageAssetPath = (descriptorDirectory / font.getPageFileName()).generic_string();
+
+	return addFont(std::move(font), pageAssetPath);
+}
+
+Engine::FontId Engine::addFont(Font&& font, const std::string& pageAssetPath)
+{
+	const TextureId textureId = registerTexture(pageAssetPath);
+	_fonts.push_back(FontEntry{ std::move(font), textureId });
+
+	return static_cast<FontId>(_fonts.size() - 1);
+}
+
+const Engine::FontEntry& Engine::getFont(FontId fontId) const
+{
+	assert(fontId < _fonts.size());
+	return _fonts[fontId];
+}
+
+Engine::Size2D Engine::getTextSize(const std::string& text, float scale, FontId fontId) const
+{
+	return getTextSize(text.data(), text.size(), scale, fontId);
+}
+
+Engine::Size2D Engine::getTextSize(const char* text, size_t length, float scale, FontId fontId) const
+{
+	const Font& font = getFont(fontId).font;
 
 	int maxHeight = 0;
 	int advance = 0;
-	for (char letter : text) {
-		Glyph& g = findGlyph(letter);
+	for (size_t i = 0; i < length; ++i) {
+		const Glyph& g = font.getGlyph(text[i]);
 		advance += g.advance + InterLetterAdvance;
 		maxHeight = std::max(maxHeight, g.height);
 	}
@@ -199,133 +457,395 @@ Engine::Size2D Engine::getTextSize(const std::string& text, float scale) const
 
 void Engine::render(TextureId textureId, const Point2D& position, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
 {
-	_renderCommands.emplace(zIndex, RenderCommand(textureId, position, color, rotation, scale, opacity));
-}
+	// Not drawn at all until the pixels are in the atlas
+	const Texture& texture = getTexture(textureId);
+	if (!texture.isResident)
+	{
+		return;
+	}
 
-void Engine::renderText(const std::string& text, const Point2D& position, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
-{
-	_renderCommands.emplace(zIndex, RenderCommand(text, position, color, rotation, scale, opacity));
+	RenderCommand command = {};
+	command.type = RenderCommandType::Sprite;
+	command.textureId = textureId;
+	command.position = position;
+	command.color = color;
+	command.rotation = rotation;
+	command.scale = scale;
+	command.opacity = opacity;
+
+	pushRenderCommand(command, zIndex, texture.region.pageTextureId);
 }
 
-void Engine::renderText(const std::string& text, const Point2D& position, const std::vector<float>& yOffsets, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
+void Engine::renderText(const std::string& text, const Point2D& position, int zIndex, const Color3D& color, float rotation, float scale, float opacity, FontId fontId)
 {
-	_renderCommands.emplace(zIndex, RenderCommand(text, position, yOffsets, color, rotation, scale, opacity));
+	static const std::vector<float> NoYOffsets;
+	renderText(text, position, NoYOffsets, zIndex, color, rotation, scale, opacity, fontId);
 }
 
-void Engine::renderCommandList()
+void Engine::renderText(const std::string& text, const Point2D& position, const std::vector<float>& yOffsets, int zIndex, const Color3D& color, float rotation, float scale, float opacity, FontId fontId)
 {
-	for (const auto& cmdIter : _renderCommands)
+	assert(yOffsets.empty() || yOffsets.size() >= text.size());
+
+	const TextureId fontTextureId = getFont(fontId).textureId;
+	if (!isTextureResident(fontTextureId))
 	{
-		const RenderCommand& cmd = cmdIter.second;
+		return;
+	}
 
-		if (cmd.textureId != std::nullopt)
-		{
-			render(cmd.textureId.value(), cmd.position.x, cmd.position.y, cmd.color, cmd.rotation, cmd.scale, cmd.opacity);
-		}
-		else if (cmd.text != std::nullopt)
-		{
-			renderText(cmd.text.value().c_str(), cmd.position.x, cmd.position.y, cmd.yOffsets, cmd.color, cmd.rotation, cmd.scale, cmd.opacity);
-		}
+	RenderCommand command = {};
+	command.type = RenderCommandType::Text;
+	command.textureId = fontTextureId;
+	command.fontId = fontId;
+	std::vector<char>& textArena = getTextArena();
+	std::vector<float>& yOffsetArena = getYOffsetArena();
+
+	command.textOffset = static_cast<uint32_t>(textArena.size());
+	command.textLength = static_cast<uint32_t>(text.size());
+	command.yOffsetsOffset = static_cast<uint32_t>(yOffsetArena.size());
+	command.numYOffsets = static_cast<uint32_t>(yOffsets.size());
+	command.position = position;
+	command.color = color;
+	command.rotation = rotation;
+	command.scale = scale;
+	command.opacity = opacity;
+
+	textArena.insert(textArena.end(), text.begin(), text.end());
+	yOffsetArena.insert(yOffsetArena.end(), yOffsets.begin(), yOffsets.end());
+
+	pushRenderCommand(command, zIndex, getTexture(fontTextureId).region.pageTextureId);
+}
+
+Engine::TextLayoutId Engine::createTextLayout(const std::string& text, FontId fontId)
+{
+	TextLayoutId layoutId;
+	if (_freeTextLayoutIds.empty()) {
+		layoutId = static_cast<TextLayoutId>(_textLayouts.size());
+		_textLayouts.emplace_back();
+	}
+	else {
+		layoutId = _freeTextLayoutIds.back();
+		_freeTextLayoutIds.pop_back();
 	}
 
-	_renderCommands.clear();
+	TextLayout& layout = _textLayouts[layoutId];
+	buildTextLayout(layout, fontId, text.data(), text.size());
+	layout.isInUse = true;
+
+	return layoutId;
 }
 
-void Engine::render(TextureId textureId, float x, float y, const glm::vec3& color, float rotation, float scale, float opacity) {
-	glm::mat4 transformation;
-	transformation = glm::translate(transformation, glm::vec3(x, y, 0.0f));
-	if (rotation) {
-		transformation = glm::rotate(transformation, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+void Engine::updateTextLayout(TextLayoutId layoutId, const std::string& text)
+{
+	assert(getTextLayout(layoutId).isInUse);
+
+	TextLayout& layout = _textLayouts[layoutId];
+	if (layout.text != text) {
+		buildTextLayout(layout, layout.fontId, text.data(), text.size());
 	}
-	if (scale)
+}
+
+void Engine::releaseTextLayout(TextLayoutId layoutId)
+{
+	assert(getTextLayout(layoutId).isInUse);
+
+	// Commands queued this frame may still reference it, the slot is recycled after rendering
+	_textLayouts[layoutId].isInUse = false;
+	_releasedTextLayoutIds.push_back(layoutId);
+}
+
+Engine::Size2D Engine::getTextLayoutSize(TextLayoutId layoutId, float scale) const
+{
+	return getTextLayout(layoutId).size * scale;
+}
+
+void Engine::renderTextLayout(TextLayoutId layoutId, const Point2D& position, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
+{
+	static const std::vector<float> NoYOffsets;
+	pushTextLayoutCommand(layoutId, position, NoYOffsets, zIndex, color, rotation, scale, opacity);
+}
+
+void Engine::renderTextLayout(TextLayoutId layoutId, const Point2D& position, const std::vector<float>& yOffsets, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
+{
+	pushTextLayoutCommand(layoutId, position, yOffsets, zIndex, color, rotation, scale, opacity);
+}
+
+const Engine::TextLayout& Engine::getTextLayout(TextLayoutId layoutId) const
+{
+	assert(layoutId < _textLayouts.size());
+	return _textLayouts[layoutId];
+}
+
+void Engine::pushTextLayoutCommand(TextLayoutId layoutId, const Point2D& position, const std::vector<float>& yOffsets, int zIndex, const Color3D& color, float rotation, float scale, float opacity)
+{
+	const TextLayout& layout = getTextLayout(layoutId);
+	assert(layout.isInUse);
+	assert(yOffsets.empty() || yOffsets.size() >= layout.glyphs.size());
+
+	if (!isTextureResident(getFont(layout.fontId).textureId))
 	{
-		transformation = glm::scale(transformation, glm::vec3(scale));
+		return;
 	}
-	render(textureId, transformation, color, opacity);
+
+	std::vector<float>& yOffsetArena = getYOffsetArena();
+
+	RenderCommand command = {};
+	command.type = RenderCommandType::TextLayout;
+	command.fontId = layout.fontId;
+	command.textLayoutId = layoutId;
+	command.yOffsetsOffset = static_cast<uint32_t>(yOffsetArena.size());
+	command.numYOffsets = static_cast<uint32_t>(yOffsets.size());
+	command.position = position;
+	command.color = color;
+	command.rotation = rotation;
+	command.scale = scale;
+	command.opacity = opacity;
+
+	yOffsetArena.insert(yOffsetArena.end(), yOffsets.begin(), yOffsets.end());
+
+	pushRenderCommand(command, zIndex, layout.pageTextureId);
 }
 
-void Engine::render(TextureId textureId, const glm::mat4& transform, const glm::vec3& color, float opacity) {
-	glLoadMatrixf(reinterpret_cast<const float*>(&transform));
+uint64_t Engine::makeSortKey(int zIndex, BlendMode blendMode, uint32_t pageTextureId) const
+{
+	using namespace SDLEngineConstants;
+
+	// [63..48] biased z-index, [47..44] blend mode, [43..28] atlas page, [27..0] submission order
+	assert(zIndex >= SortKeyMinZIndex && zIndex <= SortKeyMaxZIndex);
+	assert(_renderCommands.size() <= SortKeySequenceMask);
 
-	SDL_Surface& surface = getTexture(textureId);
+	const uint64_t z = static_cast<uint64_t>(zIndex - SortKeyMinZIndex) & 0xFFFF;
+	const uint64_t blend = static_cast<uint64_t>(blendMode) & 0xF;
+	const uint64_t page = static_cast<uint64_t>(pageTextureId) & 0xFFFF;
+	const uint64_t sequence = static_cast<uint64_t>(_renderCommands.size()) & SortKeySequenceMask;
 
-	glBindTexture(GL_TEXTURE_2D, textureId);
+	return (z << 48) | (blend << 44) | (page << 28) | sequence;
+}
 
-	GLint halfWidth = surface.w / 2;
-	GLint halfHeight = surface.h / 2;
+void Engine::pushRenderCommand(const RenderCommand& command, int zIndex, uint32_t pageTextureId)
+{
+	if (SubmitStream* stream = getCurrentSubmitStream()) {
+		stream->entries.push_back({ command, zIndex, pageTextureId });
+		return;
+	}
 
-	// Alpha blending
-	glColor4f(color.r, color.g, color.b, opacity);
+	const uint64_t key = makeSortKey(zIndex, BlendMode::Alpha, pageTextureId);
 
-	glBegin(GL_QUADS);
-	glTexCoord2i(0, 1); glVertex2i(-halfWidth, halfHeight);
-	glTexCoord2i(1, 1); glVertex2i(halfWidth, halfHeight);
-	glTexCoord2i(1, 0); glVertex2i(halfWidth, -halfHeight);
-	glTexCoord2i(0, 0); glVertex2i(-halfWidth, -halfHeight);
-	glEnd();
+	_renderSortEntries.push_back({ key, static_cast<uint32_t>(_renderCommands.size()) });
+	_renderCommands.push_back(command);
 }
 
-void Engine::renderText(const char* text, const glm::mat4& transform, const std::vector<float>& yOffsets, const glm::vec3& color, float opacity) {
-	glLoadMatrixf(reinterpret_cast<const float*>(&transform));
-	int advance = 0;
-	int offsetIndex = 0;
+void Engine::beginParallelSubmit(size_t numStreams)
+{
+	assert(_numSubmitStreams == 0);
+
+	if (_submitStreams.size() < numStreams) {
+		_submitStreams.resize(numStreams);
+	}
+	_numSubmitStreams = numStreams;
+}
+
+void Engine::endParallelSubmit()
+{
+	const size_t numStreams = _numSubmitStreams;
+	_numSubmitStreams = 0;
+
+	for (size_t i = 0; i < numStreams; ++i) {
+		SubmitStream& stream = _submitStreams[i];
+
+		// Arena offsets were taken inside the stream, rebase them onto the frame arenas
+		const uint32_t textBase = static_cast<uint32_t>(_frameTextArena.size());
+		const uint32_t yOffsetBase = static_cast<uint32_t>(_frameYOffsetArena.size());
+		_frameTextArena.insert(_frameTextArena.end(), stream.textArena.begin(), stream.textArena.end());
+		_frameYOffsetArena.insert(_frameYOffsetArena.end(), stream.yOffsetArena.begin(), stream.yOffsetArena.end());
+
+		for (SubmitStream::Entry& entry : stream.entries) {
+			entry.command.textOffset += textBase;
+			entry.command.yOffsetsOffset += yOffsetBase;
+			pushRenderCommand(entry.command, entry.zIndex, entry.pageTextureId);
+		}
+
+		stream.entries.clear();
+		stream.textArena.clear();
+		stream.yOffsetArena.clear();
+	}
+}
+
+Engine::SubmitStream* Engine::getCurrentSubmitStream()
+{
+	const size_t stream = GetCurrentSubmitStream();
+	if (stream == MainSubmitStream) {
+		return nullptr;
+	}
+
+	assert(stream < _numSubmitStreams);
+	return &_submitStreams[stream];
+}
+
+std::vector<char>& Engine::getTextArena()
+{
+	SubmitStream* stream = getCurrentSubmitStream();
+	return stream ? stream->textArena : _frameTextArena;
+}
+
+std::vector<float>& Engine::getYOffsetArena()
+{
+	SubmitStream* stream = getCurrentSubmitStream();
+	return stream ? stream->yOffsetArena : _frameYOffsetArena;
+}
+
+void Engine::sortRenderCommands()
+{
+	using namespace SDLEngineConstants;
+
+	const size_t numEntries = _renderSortEntries.size();
+	if (numEntries < 2) {
+		return;
+	}
+
+	// LSD radix sort, 8 bits per pass. All histograms are built in a single sweep
+	uint32_t histograms[SortKeyBytes][256] = {};
+	for (const RenderSortEntry& entry : _renderSortEntries) {
+		for (size_t byte = 0; byte < SortKeyBytes; ++byte) {
+			histograms[byte][(entry.key >> (byte * 8)) & 0xFF]++;
+		}
+	}
 
-	SDL_Surface& fontSurface = getTexture(_fontSurfaceTextureId);
+	_renderSortScratch.resize(numEntries);
 
-	for (; *text; ++text) {
-		Glyph& g = findGlyph(*text);
+	for (size_t byte = 0; byte < SortKeyBytes; ++byte) {
+		uint32_t* histogram = histograms[byte];
+
+		// Every key shares this byte, the pass would not move anything
+		const uint32_t firstBucket = static_cast<uint32_t>((_renderSortEntries.front().key >> (byte * 8)) & 0xFF);
+		if (histogram[firstBucket] == numEntries) {
+			continue;
+		}
 
-		float yOffset = 0.0f;
-		if (!yOffsets.empty())
+		uint32_t offset = 0;
+		for (size_t bucket = 0; bucket < 256; ++bucket) {
+			const uint32_t count = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += count;
+		}
+
+		for (const RenderSortEntry& entry : _renderSortEntries) {
+			_renderSortScratch[histogram[(entry.key >> (byte * 8)) & 0xFF]++] = entry;
+		}
+		_renderSortEntries.swap(_renderSortScratch);
+	}
+}
+
+void Engine::renderCommandList()
+{
+	sortRenderCommands();
+
+	for (const RenderSortEntry& entry : _renderSortEntries)
+	{
+		const RenderCommand& cmd = _renderCommands[entry.commandIndex];
+
+		switch (cmd.type)
 		{
-			yOffset = yOffsets.at(offsetIndex++);
+			case RenderCommandType::Sprite:
+				render(cmd.textureId, cmd.position.x, cmd.position.y, cmd.color, cmd.rotation, cmd.scale, cmd.opacity);
+				break;
+			case RenderCommandType::Text:
+				// Immediate text goes through a scratch layout that keeps its storage between calls
+				buildTextLayout(_immediateTextLayout, cmd.fontId, _frameTextArena.data() + cmd.textOffset, cmd.textLength);
+				renderTextLayout(_immediateTextLayout, cmd.position.x, cmd.position.y,
+					_frameYOffsetArena.data() + cmd.yOffsetsOffset, cmd.numYOffsets, cmd.color, cmd.rotation, cmd.scale, cmd.opacity);
+				break;
+			case RenderCommandType::TextLayout:
+				renderTextLayout(getTextLayout(cmd.textLayoutId), cmd.position.x, cmd.position.y,
+					_frameYOffsetArena.data() + cmd.yOffsetsOffset, cmd.numYOffsets, cmd.color, cmd.rotation, cmd.scale, cmd.opacity);
+				break;
 		}
+	}
+	_quadRenderer->flush();
 
-		float fontTexWidth = static_cast<float>(fontSurface.w);
-		float fontTexHeight = static_cast<float>(fontSurface.h);
+	_freeTextLayoutIds.insert(_freeTextLayoutIds.end(), _releasedTextLayoutIds.begin(), _releasedTextLayoutIds.end());
+	_releasedTextLayoutIds.clear();
 
-		float uvLeft = static_cast<float>(g.x) / fontTexWidth;
-		float uvRight = static_cast<float>(g.x + g.width) / fontTexWidth;
-		float uvBottom = static_cast<float>(g.y) / fontTexHeight;
-		float uvTop = static_cast<float>(g.y + g.height) / fontTexHeight;
+	// clear() keeps the capacity, so steady-state frames do not allocate
+	_renderCommands.clear();
+	_renderSortEntries.clear();
+	_frameTextArena.clear();
+	_frameYOffsetArena.clear();
+}
 
-		float worldLeft = static_cast<float>(g.xoffset + advance);
-		float worldRight = static_cast<float>(g.xoffset + g.width + advance);
-		float worldBottom = static_cast<float>(g.yoffset + yOffset);
-		float worldTop = static_cast<float>(g.yoffset + g.height + yOffset);
+void Engine::render(TextureId textureId, float x, float y, const glm::vec3& color, float rotation, float scale, float opacity) {
+	const TextureAtlas::Region& region = getTexture(textureId).region;
+
+	// Odd sizes lose their last pixel, sprites stay centred on whole pixels
+	const glm::vec2 halfSize(static_cast<float>(region.width / 2), static_cast<float>(region.height / 2));
+
+	_quadRenderer->push(region.pageTextureId, QuadInstance::Create(glm::vec2(x, y), glm::vec2(0.0f), halfSize,
+		rotation, GetEffectiveScale(scale), region.uvRect, QuadInstance::PackColor(color, opacity)));
+}
 
-		glBindTexture(GL_TEXTURE_2D, _fontSurfaceTextureId);
+void Engine::buildTextLayout(TextLayout& layout, FontId fontId, const char* text, size_t length) {
+	const FontEntry& fontEntry = getFont(fontId);
+	const TextureAtlas::Region& fontRegion = getTexture(fontEntry.textureId).region;
 
-		// Alpha blending
-		glColor4f(color.r, color.g, color.b, opacity);
+	// Glyph rects are in font sheet pixels, the sheet itself is a sub-rectangle of an atlas page
+	const float fontTexWidth = static_cast<float>(fontRegion.width);
+	const float fontTexHeight = static_cast<float>(fontRegion.height);
+	const float uvWidth = fontRegion.uvRect.z - fontRegion.uvRect.x;
+	const float uvHeight = fontRegion.uvRect.w - fontRegion.uvRect.y;
 
-		glBegin(GL_QUADS);
-		glTexCoord2f(uvLeft, uvTop); glVertex2f(worldLeft, worldTop);
-		glTexCoord2f(uvRight, uvTop); glVertex2f(worldRight, worldTop);
-		glTexCoord2f(uvRight, uvBottom); glVertex2f(worldRight, worldBottom);
-		glTexCoord2f(uvLeft, uvBottom); glVertex2f(worldLeft, worldBottom);
-		glEnd();
+	layout.fontId = fontId;
+	layout.pageTextureId = fontRegion.pageTextureId;
+	layout.text.assign(text, length);
+	layout.glyphs.clear();
+
+	int advance = 0;
+	int maxHeight = 0;
+
+	for (size_t i = 0; i < length; ++i) {
+		const Glyph& g = fontEntry.font.getGlyph(text[i]);
+
+		float uvLeft = fontRegion.uvRect.x + static_cast<float>(g.x) / fontTexWidth * uvWidth;
+		float uvRight = fontRegion.uvRect.x + static_cast<float>(g.x + g.width) / fontTexWidth * uvWidth;
+		float uvBottom = fontRegion.uvRect.y + static_cast<float>(g.y) / fontTexHeight * uvHeight;
+		float uvTop = fontRegion.uvRect.y + static_cast<float>(g.y + g.height) / fontTexHeight * uvHeight;
+
+		float worldLeft = static_cast<float>(g.xoffset + advance);
+		float worldRight = static_cast<float>(g.xoffset + g.width + advance);
+		float worldBottom = static_cast<float>(g.yoffset);
+		float worldTop = static_cast<float>(g.yoffset + g.height);
+
+		layout.glyphs.push_back({ glm::vec4(worldLeft, worldBottom, worldRight, worldTop), glm::vec4(uvLeft, uvBottom, uvRight, uvTop) });
 
 		advance += g.advance + InterLetterAdvance;
+		maxHeight = std::max(maxHeight, g.height);
 	}
+
+	layout.size = Size2D(advance, maxHeight);
 }
 
-void Engine::renderText(const char* text, float x, float y, const std::vector<float>& yOffsets, const glm::vec3& color, float rotation, float scale, float opacity) {
-	Size2D textSize = getTextSize(text, scale);
+void Engine::renderTextLayout(const TextLayout& layout, float x, float y, const float* yOffsets, size_t numYOffsets, const glm::vec3& color, float rotation, float scale, float opacity) {
+	Size2D textSize = layout.size * scale;
 
-	float xPos = x - textSize.x / 2.0f;
-	float yPos = y - textSize.y / 2.0f;
+	// Glyphs rotate and scale around the top-left corner of the text
+	const glm::vec2 pivot(x - textSize.x / 2.0f, y - textSize.y / 2.0f);
+	const float effectiveScale = GetEffectiveScale(scale);
+	const uint32_t packedColor = QuadInstance::PackColor(color, opacity);
 
-	glm::mat4 transformation;
-	transformation = glm::translate(transformation, glm::vec3(xPos, yPos, 0.0f));
-	if (rotation) {
-		transformation = glm::rotate(transformation, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
-	}
-	if (scale)
-	{
-		transformation = glm::scale(transformation, glm::vec3(scale));
+	for (size_t i = 0; i < layout.glyphs.size(); ++i) {
+		const TextLayoutGlyph& glyph = layout.glyphs[i];
+
+		glm::vec4 worldRect = glyph.worldRect;
+		if (numYOffsets > 0)
+		{
+			assert(i < numYOffsets);
+			worldRect.y += yOffsets[i];
+			worldRect.w += yOffsets[i];
+		}
+
+		const glm::vec2 centre = (glm::vec2(worldRect.x, worldRect.y) + glm::vec2(worldRect.z, worldRect.w)) * 0.5f;
+		const glm::vec2 halfSize = (glm::vec2(worldRect.z, worldRect.w) - glm::vec2(worldRect.x, worldRect.y)) * 0.5f;
+
+		_quadRenderer->push(layout.pageTextureId, QuadInstance::Create(pivot, centre, halfSize, rotation, effectiveScale, glyph.uvRect, packedColor));
 	}
-	renderText(text, transformation, yOffsets, color, opacity);
 }
 
 void Engine::handleMouseEvents()
@@ -351,12 +871,12 @@ void Engine::handleMouseEvents()
 		}
 	}
 }
-SDL_Surface& Engine::getTexture(TextureId textureId) const
+const Engine::Texture& Engine::getTexture(TextureId textureId) const
 {
 	auto& textureIter = _textureMapById.find(textureId);
 	assert(textureIter != _textureMapById.end());
 
-	return *(textureIter->second);
+	return textureIter->second;
 }
 
 void Engine::destroyTexture(SDL_Surface* texture)
@@ -364,11 +884,9 @@ void Engine::destroyTexture(SDL_Surface* texture)
 	SDL_FreeSurface(texture);
 }
 
-std::optional<Engine::TextureId> Engine::findTextureByAsset(const std::string& assetPath)
+std::optional<Engine::TextureId> Engine::findTextureByAsset(const std::string& assetKey) const
 {
-	const std::string assetFullPath = getFullPathFromAssetName(assetPath);
-
-	const auto &assetTextureIdIter = _textureMapByAssetName.find(assetFullPath);
+	const auto assetTextureIdIter = _textureMapByAssetName.find(assetKey);
 	if (assetTextureIdIter != _textureMapByAssetName.end())
 	{
 		return assetTextureIdIter->second;
@@ -376,17 +894,8 @@ std::optional<Engine::TextureId> Engine::findTextureByAsset(const std::string& a
 	return std::nullopt;
 }
 
-float Engine::getCharacterAdvance(char character, float scale) const
+float Engine::getCharacterAdvance(char character, float scale, FontId fontId) const
 {
-	Glyph& g = findGlyph(character);
+	const Glyph& g = getFont(fontId).font.getGlyph(character);
 	return static_cast<float>(g.advance + InterLetterAdvance) * scale;
 }
-
-Glyph& Engine::findGlyph(char c) const
-{
-	auto found = std::lower_bound(std::begin(Font), std::end(Font), c);
-	if (found == std::end(Font) || c < *found) {
-		found = std::lower_bound(std::begin(Font), std::end(Font), static_cast<int>('_'));
-	}
-	return *found;
-}
\ No newline at end of file
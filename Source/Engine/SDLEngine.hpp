@@ -7,32 +7,20 @@
 #pragma once
 
 #include <optional>
-#include <map>
+#include <vector>
+#include <unordered_map>
 
 #include "Framework/Core/Engine.hpp"
 #include "Framework/Core/Types.hpp"
+#include "SDLTextureAtlas.hpp"
+#include "SDLFont.hpp"
+#include "SDLTextureLoader.hpp"
+#include "SDLQuadRenderer.hpp"
 
 #include <sdl/SDL.h>
 
 namespace SDL
 {
-#pragma region - Font
-	struct Glyph {
-		int id;
-		int x;
-		int y;
-		int width;
-		int height;
-		int xoffset;
-		int yoffset;
-		int advance;
-	};
-
-	inline bool operator<(const Glyph& glyph, int id) { return glyph.id < id; }
-	inline bool operator<(int id, const Glyph& glyph) { return id < glyph.id; }
-
-	extern Glyph Font[191];
-
 	class Engine;
 	using EngineOwner = std::shared_ptr<Engine>;
 	using EngineRef = Engine & ;
@@ -45,7 +33,7 @@ namespace SDL
 
 		static EngineOwner Create(const Settings& settings);
 
-		~Engine() override = default;
+		~Engine() override;
 
 		void start(Framework::Types::GameObject::PtrType updater) override;
 		void stop() override;
@@ -55,13 +43,33 @@ namespace SDL
 		Size getScreenSize() const override;
 		float getElapsedTime() const override;
 
-		TextureId registerTexture(const std::string& assetPath) override;
+		TextureId registerTexture(const std::string& assetPath, bool keepCpuCopy = false) override;
+		bool isTextureResident(TextureId textureId) const override;
+		std::vector<TextureId> preloadTextures(const std::vector<std::string>& assetPaths) override;
+		void waitForPendingTextures() override;
+		void releaseTexture(TextureId textureId) override;
+		void purgeUnusedTextures() override;
+		TextureCacheStats getTextureCacheStats() const override;
+		TextureInfo getTextureInfo(TextureId textureId) const override;
+		TextureMemoryStats getTextureMemoryStats() const override;
 		Size getTextureSize(TextureId spriteId) const override;
-		Size2D getTextSize(const std::string& text, float scale) const override;
+		FontId registerFont(const std::string& descriptorAssetPath) override;
+		Size2D getTextSize(const std::string& text, float scale, FontId fontId = DefaultFontId) const override;
+		float getCharacterAdvance(char character, float scale = 1.0f, FontId fontId = DefaultFontId) const override;
 
 		void render(TextureId spriteId, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) override;
-		void renderText(const std::string& text, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) override;
-		void renderText(const std::string& text, const Point2D& position, const std::vector<float>& yPositions, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) override;
+		void renderText(const std::string& text, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f, FontId fontId = DefaultFontId) override;
+		void renderText(const std::string& text, const Point2D& position, const std::vector<float>& yPositions, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f, FontId fontId = DefaultFontId) override;
+
+		TextLayoutId createTextLayout(const std::string& text, FontId fontId = DefaultFontId) override;
+		void updateTextLayout(TextLayoutId layoutId, const std::string& text) override;
+		void releaseTextLayout(TextLayoutId layoutId) override;
+		Size2D getTextLayoutSize(TextLayoutId layoutId, float scale = 1.0f) const override;
+		void renderTextLayout(TextLayoutId layoutId, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) override;
+		void renderTextLayout(TextLayoutId layoutId, const Point2D& position, const std::vector<float>& yOffsets, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) override;
+
+		void beginParallelSubmit(size_t numStreams) override;
+		void endParallelSubmit() override;
 
 	protected:
 		template<class _Ty>
@@ -69,49 +77,86 @@ namespace SDL
 		Engine(const Settings& settings);
 
 	private:
-		struct RenderCommand
+#pragma region - Render queue
+		enum class BlendMode : uint8_t
 		{
-			RenderCommand(TextureId textureId_, const Point2D& position_, const Color3D& color_, float rotation_, float scale_, float opacity_)
-				: textureId(textureId_)
-				, position(position_)
-				, color(color_)
-				, rotation(rotation_)
-				, scale(scale_)
-				, opacity(opacity_)
-			{}
-			RenderCommand(const std::string& text_, const Point2D& position_, const Color3D& color_, float rotation_, float scale_, float opacity_)
-				: text(text_)
-				, position(position_)
-				, color(color_)
-				, rotation(rotation_)
-				, scale(scale_)
-				, opacity(opacity_)
-			{}
-			RenderCommand(const std::string& text_, const Point2D& position_, const std::vector<float> yOffsets, const Color3D& color_, float rotation_, float scale_, float opacity_)
-				: text(text_)
-				, position(position_)
-				, yOffsets(yOffsets)
-				, color(color_)
-				, rotation(rotation_)
-				, scale(scale_)
-				, opacity(opacity_)
-			{}
-
-			std::optional<TextureId> textureId;
-			std::optional<std::string> text;
+			Alpha = 0,
+			// Room for up to 16 modes in the sort key
+		};
 
+		enum class RenderCommandType : uint8_t
+		{
+			Sprite,
+			Text,
+			TextLayout,
+		};
+
+		// Plain data so the per-frame queue is a flat array. Text and y offsets live in the frame arenas
+		struct RenderCommand
+		{
+			RenderCommandType type;
+			TextureId textureId;
+			FontId fontId;
+			TextLayoutId textLayoutId;
+			uint32_t textOffset;
+			uint32_t textLength;
+			uint32_t yOffsetsOffset;
+			uint32_t numYOffsets;
 			Point2D position;
-			std::vector<float> yOffsets;
 			Color3D color;
-			float scale = 1.0f;
-			float rotation = 0.0f;
-			float opacity = 0.0f;
+			float rotation;
+			float scale;
+			float opacity;
 		};
 
+		struct RenderSortEntry
+		{
+			uint64_t key;
+			uint32_t commandIndex;
+		};
+
+		// Commands of one parallel job, sort keys are only made once the streams are merged in order
+		struct SubmitStream
+		{
+			struct Entry
+			{
+				RenderCommand command;
+				int zIndex;
+				uint32_t pageTextureId;
+			};
+
+			std::vector<Entry> entries;
+			std::vector<char> textArena;
+			std::vector<float> yOffsetArena;
+		};
+
+		uint64_t makeSortKey(int zIndex, BlendMode blendMode, uint32_t pageTextureId) const;
+		void pushRenderCommand(const RenderCommand& command, int zIndex, uint32_t pageTextureId);
+		void sortRenderCommands();
+		SubmitStream* getCurrentSubmitStream();
+		std::vector<char>& getTextArena();
+		std::vector<float>& getYOffsetArena();
+
 #pragma region - Texture handling
+		struct Texture
+		{
+			TextureAtlas::Region region;
+			uint32_t pixelFormat = 0;
+			SDL_Surface* cpuCopy = nullptr;
+			std::string assetKey;
+			uint32_t refCount = 0;
+			bool isResident = false;
+			bool keepCpuCopy = false;
+		};
+
+		void completeTextureLoad(TextureLoader::Result& result);
+		void processLoadedTextures(float budgetSeconds);
+
+		SDL_Surface* loadSurface(const std::string& assetFullPath) const;
+		size_t getSurfaceBytes(const SDL_Surface* surface) const;
 		void destroyTexture(SDL_Surface* texture);
-		std::optional<TextureId> findTextureByAsset(const std::string& assetPath);
-		SDL_Surface& getTexture(TextureId textureId) const;
+		std::optional<TextureId> findTextureByAsset(const std::string& assetKey) const;
+		const Texture& getTexture(TextureId textureId) const;
 
 		void renderCommandList();
 		void handleMouseEvents();
@@ -119,22 +164,64 @@ namespace SDL
 #pragma region - Text/font handling
 		const int InterLetterAdvance = 3;
 
-		float getCharacterAdvance(char character, float scale) const;
-		Glyph& findGlyph(char c) const;
+		struct FontEntry
+		{
+			Font font;
+			TextureId textureId;
+		};
+
+		// Glyph quads in font units, rects are (left, top, right, bottom)
+		struct TextLayoutGlyph
+		{
+			glm::vec4 worldRect;
+			glm::vec4 uvRect;
+		};
+
+		struct TextLayout
+		{
+			FontId fontId = DefaultFontId;
+			uint32_t pageTextureId = 0;
+			std::string text;
+			Size2D size;
+			std::vector<TextLayoutGlyph> glyphs;
+			bool isInUse = false;
+		};
+
+		FontId addFont(Font&& font, const std::string& pageAssetPath);
+		const FontEntry& getFont(FontId fontId) const;
+		Size2D getTextSize(const char* text, size_t length, float scale, FontId fontId) const;
 
 #pragma region - Rendering
 		void render(TextureId textureId, float x, float y, const glm::vec3& color, float rotation, float scale, float opacity);
-		void render(TextureId textureId, const glm::mat4& transform, const glm::vec3& color, float opacity);
-		void renderText(const char* text, const glm::mat4& transform, const std::vector<float>& yOffsets, const glm::vec3& color, float opacity);
-		void renderText(const char* text, float x, float y, const std::vector<float>& yOffsets, const glm::vec3& color, float rotation, float scale, float opacity);
+		void buildTextLayout(TextLayout& layout, FontId fontId, const char* text, size_t length);
+		const TextLayout& getTextLayout(TextLayoutId layoutId) const;
+		void pushTextLayoutCommand(TextLayoutId layoutId, const Point2D& position, const std::vector<float>& yOffsets, int zIndex, const Color3D& color, float rotation, float scale, float opacity);
+		void renderTextLayout(const TextLayout& layout, float x, float y, const float* yOffsets, size_t numYOffsets, const glm::vec3& color, float rotation, float scale, float opacity);
 
 		std::string getFullPathFromAssetName(const std::string& assetName) const;
 
 		void* _GLContext = nullptr;
-		TextureId _fontSurfaceTextureId = 0;
-		std::unordered_map<TextureId, SDL_Surface*> _textureMapById;
+		TextureId _nextTextureId = 1;
+		TextureAtlas _atlas;
+		TextureLoader _textureLoader;
+		float _textureUploadBudgetSeconds = 0.0f;
+		std::unordered_map<TextureId, Texture> _textureMapById;
 		std::unordered_map<std::string, TextureId> _textureMapByAssetName;
-		std::multimap<int, RenderCommand, std::less<int>> _renderCommands;
+		TextureCacheStats _textureCacheStats;
+		std::vector<FontEntry> _fonts;
+		std::vector<TextLayout> _textLayouts;
+		std::vector<TextLayoutId> _freeTextLayoutIds;
+		std::vector<TextLayoutId> _releasedTextLayoutIds;
+		TextLayout _immediateTextLayout;
+		std::vector<RenderCommand> _renderCommands;
+		std::vector<RenderSortEntry> _renderSortEntries;
+		std::vector<RenderSortEntry> _renderSortScratch;
+		std::vector<char> _frameTextArena;
+		std::vector<float> _frameYOffsetArena;
+		std::vector<SubmitStream> _submitStreams;	// Kept between frames so their storage is reused
+		size_t _numSubmitStreams = 0;
+
+		std::unique_ptr<QuadRenderer> _quadRenderer;
 
 		std::string _assetsDirectoryPath;
 		Framework::Types::GameObject::PtrType _updater;
@@ -0,0 +1,62 @@
+//
+// SDLFont.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstdint>
+
+namespace SDL
+{
+	struct Glyph
+	{
+		int id;
+		int x;
+		int y;
+		int width;
+		int height;
+		int xoffset;
+		int yoffset;
+		int advance;
+	};
+
+	//
+	// Bitmap font with a single texture page. Glyphs are stored in a table indexed directly by
+	// the character byte, characters missing from the font resolve to the fallback glyph
+	//
+	class Font final
+	{
+	public:
+		static const int NumGlyphs = 256;
+		static const int FallbackCodePoint = '_';
+
+		using GlyphTable = std::array<Glyph, NumGlyphs>;
+
+		// Glyph metrics built into the engine for berlin_sans_demi_72_0.png
+		static Font CreateBuiltIn(const std::string& pageFileName);
+
+		// Loads an AngelCode BMFont descriptor, either the text or the binary flavour
+		static Font LoadFromBMFont(const std::string& descriptorPath);
+
+		const Glyph& getGlyph(char character) const
+		{
+			return _glyphs[static_cast<unsigned char>(character)];
+		}
+
+		// Relative to the descriptor directory
+		const std::string& getPageFileName() const;
+
+	private:
+		Font(const GlyphTable& glyphs, const std::string& pageFileName);
+
+		static Font LoadFromBMFontText(const std::string& contents, const std::string& descriptorPath);
+		static Font LoadFromBMFontBinary(const std::string& contents, const std::string& descriptorPath);
+
+		GlyphTable _glyphs;
+		std::string _pageFileName;
+	};
+}
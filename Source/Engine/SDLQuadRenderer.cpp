@@ -0,0 +1,51 @@
+//
+// SDLQuadRenderer.cpp
+//
+// @author Roberto Cano
+//
+
+#include "SDLQuadRenderer.hpp"
+
+using namespace SDL;
+
+namespace QuadRendererConstants
+{
+	const float MaxUvValue = 65535.0f;
+}
+
+QuadInstance QuadInstance::Create(const glm::vec2& position, const glm::vec2& offset, const glm::vec2& halfSize, float rotation, float scale, const glm::vec4& uvRect, uint32_t color)
+{
+	using namespace QuadRendererConstants;
+
+	const glm::vec4 uvs = glm::clamp(uvRect, 0.0f, 1.0f) * MaxUvValue + 0.5f;
+
+	QuadInstance instance;
+	instance.position = position;
+	instance.offset = offset;
+	instance.halfSize = halfSize;
+	instance.rotation = rotation;
+	instance.scale = scale;
+	instance.uvRect[0] = static_cast<uint16_t>(uvs.x);
+	instance.uvRect[1] = static_cast<uint16_t>(uvs.y);
+	instance.uvRect[2] = static_cast<uint16_t>(uvs.z);
+	instance.uvRect[3] = static_cast<uint16_t>(uvs.w);
+	instance.color = color;
+	instance.padding = 0;
+	return instance;
+}
+
+uint32_t QuadInstance::PackColor(const glm::vec3& color, float opacity)
+{
+	const glm::vec4 clamped = glm::clamp(glm::vec4(color, opacity), 0.0f, 1.0f) * 255.0f + 0.5f;
+	return static_cast<uint32_t>(clamped.r) |
+		(static_cast<uint32_t>(clamped.g) << 8) |
+		(static_cast<uint32_t>(clamped.b) << 16) |
+		(static_cast<uint32_t>(clamped.a) << 24);
+}
+
+glm::vec4 QuadInstance::getUvRect() const
+{
+	using namespace QuadRendererConstants;
+
+	return glm::vec4(uvRect[0], uvRect[1], uvRect[2], uvRect[3]) / MaxUvValue;
+}
@@ -0,0 +1,52 @@
+//
+// SDLQuadRenderer.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace SDL
+{
+	//
+	// Everything needed to draw one textured quad. The layout matches the per-instance
+	// vertex attributes of the instanced renderer, so submitting a quad is a 48 byte copy
+	//
+	struct QuadInstance
+	{
+		glm::vec2 position;		// Pivot in screen pixels
+		glm::vec2 offset;		// Quad centre relative to the pivot, before rotation and scale
+		glm::vec2 halfSize;
+		float rotation;
+		float scale;
+		uint16_t uvRect[4];		// Normalised (left, top, right, bottom)
+		uint32_t color;			// RGBA8, opacity in alpha
+		uint32_t padding;
+
+		static QuadInstance Create(const glm::vec2& position, const glm::vec2& offset, const glm::vec2& halfSize, float rotation, float scale, const glm::vec4& uvRect, uint32_t color);
+		static uint32_t PackColor(const glm::vec3& color, float opacity);
+
+		glm::vec4 getUvRect() const;
+	};
+
+	static_assert(sizeof(QuadInstance) == 48, "QuadInstance must match the instanced vertex layout");
+
+	//
+	// Draw backend used by the engine once the render queue is sorted. Quads arrive in
+	// draw order, consecutive quads on the same atlas page can be drawn together
+	//
+	class QuadRenderer
+	{
+	public:
+		virtual ~QuadRenderer() = default;
+
+		virtual void push(uint32_t pageTextureId, const QuadInstance& instance) = 0;
+
+		// Draws everything pushed since the last flush, called once at the end of every frame
+		virtual void flush() = 0;
+	};
+}
@@ -0,0 +1,316 @@
+//
+// SDLTextureAtlas.cpp
+//
+// @author Roberto Cano
+//
+
+#include "SDLTextureAtlas.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cassert>
+#include <string>
+
+#include <glew/glew.h>
+#include <sdl/SDL.h>
+
+using namespace SDL;
+
+namespace TextureAtlasConstants
+{
+	// Every image is surrounded by a copy of its own border so linear filtering
+	// never samples the neighbouring image
+	const int Padding = 1;
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	const Uint32 PixelFormat = SDL_PIXELFORMAT_RGBA8888;
+#else
+	const Uint32 PixelFormat = SDL_PIXELFORMAT_ABGR8888;
+#endif
+}
+
+TextureAtlas::TextureAtlas(int pageSize)
+	: _pageSize(pageSize)
+{
+	// Empty on purpose
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	for (const Page& page : _pages)
+	{
+		GLuint textureId = page.textureId;
+		glDeleteTextures(1, &textureId);
+	}
+}
+
+TextureAtlas::Region TextureAtlas::add(SDL_Surface& surface)
+{
+	Region region = allocate(surface.w, surface.h);
+	upload(region, surface);
+	return region;
+}
+
+TextureAtlas::Region TextureAtlas::allocate(int width, int height)
+{
+	using namespace TextureAtlasConstants;
+
+	const int paddedWidth = width + 2 * Padding;
+	const int paddedHeight = height + 2 * Padding;
+
+	Page* targetPage = nullptr;
+	int nodeIndex = -1;
+	int x = 0;
+	int y = 0;
+
+	for (Page& page : _pages)
+	{
+		nodeIndex = findPosition(page, paddedWidth, paddedHeight, x, y);
+		if (nodeIndex >= 0)
+		{
+			targetPage = &page;
+			break;
+		}
+	}
+
+	if (targetPage == nullptr)
+	{
+		targetPage = &createPage(std::max(_pageSize, paddedWidth), std::max(_pageSize, paddedHeight));
+		nodeIndex = findPosition(*targetPage, paddedWidth, paddedHeight, x, y);
+		assert(nodeIndex >= 0);
+	}
+
+	commitAllocation(*targetPage, static_cast<size_t>(nodeIndex), x, y, paddedWidth, paddedHeight);
+	targetPage->numRegions++;
+
+	Region region;
+	region.pageTextureId = targetPage->textureId;
+	region.x = x + Padding;
+	region.y = y + Padding;
+	region.width = width;
+	region.height = height;
+
+	const float pageWidth = static_cast<float>(targetPage->width);
+	const float pageHeight = static_cast<float>(targetPage->height);
+	region.uvRect = glm::vec4(region.x / pageWidth, region.y / pageHeight,
+		(region.x + region.width) / pageWidth, (region.y + region.height) / pageHeight);
+
+	return region;
+}
+
+void TextureAtlas::remove(const Region& region)
+{
+	auto pageIter = std::find_if(_pages.begin(), _pages.end(), [&region](const Page& page) {
+		return page.textureId == region.pageTextureId;
+	});
+	assert(pageIter != _pages.end());
+	assert(pageIter->numRegions > 0);
+
+	pageIter->numRegions--;
+	if (pageIter->numRegions == 0)
+	{
+		pageIter->skyline.clear();
+		pageIter->skyline.push_back(SkylineNode{ 0, 0, pageIter->width });
+	}
+}
+
+size_t TextureAtlas::getNumPages() const
+{
+	return _pages.size();
+}
+
+size_t TextureAtlas::getGpuBytes() const
+{
+	size_t numBytes = 0;
+	for (const Page& page : _pages)
+	{
+		numBytes += static_cast<size_t>(page.width) * page.height * sizeof(uint32_t);
+	}
+	return numBytes;
+}
+
+size_t TextureAtlas::GetRegionBytes(const Region& region)
+{
+	using namespace TextureAtlasConstants;
+
+	return static_cast<size_t>(region.width + 2 * Padding) * (region.height + 2 * Padding) * sizeof(uint32_t);
+}
+
+TextureAtlas::Page& TextureAtlas::createPage(int width, int height)
+{
+	GLuint textureId;
+
+	glGenTextures(1, &textureId);
+	glBindTexture(GL_TEXTURE_2D, textureId);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	Page page;
+	page.textureId = textureId;
+	page.width = width;
+	page.height = height;
+	page.skyline.push_back(SkylineNode{ 0, 0, width });
+
+	_pages.push_back(std::move(page));
+	return _pages.back();
+}
+
+int TextureAtlas::findPosition(const Page& page, int width, int height, int& x, int& y) const
+{
+	int bestIndex = -1;
+	int bestBottom = std::numeric_limits<int>::max();
+	int bestWidth = std::numeric_limits<int>::max();
+
+	// Bottom-left heuristic: lowest resulting top edge wins, narrowest node breaks ties
+	for (size_t i = 0; i < page.skyline.size(); ++i)
+	{
+		const int fitY = getSkylineFitY(page, i, width, height);
+		if (fitY < 0)
+		{
+			continue;
+		}
+
+		const int bottom = fitY + height;
+		if (bottom < bestBottom || (bottom == bestBottom && page.skyline[i].width < bestWidth))
+		{
+			bestIndex = static_cast<int>(i);
+			bestBottom = bottom;
+			bestWidth = page.skyline[i].width;
+			x = page.skyline[i].x;
+			y = fitY;
+		}
+	}
+
+	return bestIndex;
+}
+
+int TextureAtlas::getSkylineFitY(const Page& page, size_t nodeIndex, int width, int height) const
+{
+	const SkylineNode& firstNode = page.skyline[nodeIndex];
+	if (firstNode.x + width > page.width)
+	{
+		return -1;
+	}
+
+	int y = firstNode.y;
+	int widthLeft = width;
+
+	for (size_t i = nodeIndex; widthLeft > 0; ++i)
+	{
+		assert(i < page.skyline.size());
+
+		y = std::max(y, page.skyline[i].y);
+		if (y + height > page.height)
+		{
+			return -1;
+		}
+		widthLeft -= page.skyline[i].width;
+	}
+
+	return y;
+}
+
+void TextureAtlas::commitAllocation(Page& page, size_t nodeIndex, int x, int y, int width, int height)
+{
+	std::vector<SkylineNode>& skyline = page.skyline;
+
+	skyline.insert(skyline.begin() + nodeIndex, SkylineNode{ x, y + height, width });
+
+	// Trim the nodes now covered by the new one
+	for (size_t i = nodeIndex + 1; i < skyline.size(); )
+	{
+		const SkylineNode& previous = skyline[i - 1];
+		SkylineNode& node = skyline[i];
+
+		const int previousRight = previous.x + previous.width;
+		if (node.x >= previousRight)
+		{
+			break;
+		}
+
+		const int shrink = previousRight - node.x;
+		node.x += shrink;
+		node.width -= shrink;
+
+		if (node.width <= 0)
+		{
+			skyline.erase(skyline.begin() + i);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	// Merge neighbours at the same height
+	for (size_t i = 0; i + 1 < skyline.size(); )
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+uint32_t TextureAtlas::GetPixelFormat()
+{
+	return TextureAtlasConstants::PixelFormat;
+}
+
+void TextureAtlas::upload(const Region& region, SDL_Surface& surface)
+{
+	using namespace TextureAtlasConstants;
+
+	assert(surface.w == region.width && surface.h == region.height);
+
+	// Surfaces already in the page format, e.g. prepared by the loader threads, skip the conversion
+	const bool needsConversion = surface.format->format != PixelFormat;
+
+	SDL_Surface* converted = needsConversion ? SDL_ConvertSurfaceFormat(&surface, PixelFormat, 0) : &surface;
+	if (converted == nullptr)
+	{
+		throw std::runtime_error(std::string("Unable to convert texture for the atlas: ") + SDL_GetError());
+	}
+
+	const int width = converted->w;
+	const int height = converted->h;
+	const int paddedWidth = width + 2 * Padding;
+	const int paddedHeight = height + 2 * Padding;
+
+	_uploadBuffer.resize(static_cast<size_t>(paddedWidth) * paddedHeight);
+
+	SDL_LockSurface(converted);
+	for (int row = 0; row < paddedHeight; ++row)
+	{
+		// Rows and columns outside the image repeat the nearest edge pixel
+		const int sourceRow = std::min(std::max(row - Padding, 0), height - 1);
+		const uint32_t* source = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(converted->pixels) + sourceRow * converted->pitch);
+		uint32_t* destination = _uploadBuffer.data() + static_cast<size_t>(row) * paddedWidth;
+
+		std::memcpy(destination + Padding, source, width * sizeof(uint32_t));
+		for (int column = 0; column < Padding; ++column)
+		{
+			destination[column] = source[0];
+			destination[paddedWidth - 1 - column] = source[width - 1];
+		}
+	}
+	SDL_UnlockSurface(converted);
+	if (needsConversion)
+	{
+		SDL_FreeSurface(converted);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, region.pageTextureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, region.x - Padding, region.y - Padding, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, _uploadBuffer.data());
+}
@@ -0,0 +1,86 @@
+//
+// SDLTextureAtlas.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+struct SDL_Surface;
+
+namespace SDL
+{
+	//
+	// Packs images into a set of shared GL textures (pages) using a skyline allocator,
+	// so sprites and the font sheet can be drawn without rebinding textures. Images
+	// bigger than a page get a page of their own
+	//
+	class TextureAtlas final
+	{
+	public:
+		struct Region
+		{
+			uint32_t pageTextureId = 0;
+			int x = 0;
+			int y = 0;
+			int width = 0;
+			int height = 0;
+			glm::vec4 uvRect; // (left, top, right, bottom)
+		};
+
+		explicit TextureAtlas(int pageSize);
+		~TextureAtlas();
+
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+		Region add(SDL_Surface& surface);
+
+		// Reserves the space first, so the pixels can be uploaded later once they are decoded
+		Region allocate(int width, int height);
+		void upload(const Region& region, SDL_Surface& surface);
+
+		// Space is reclaimed per page, once every region on it has been removed
+		void remove(const Region& region);
+
+		size_t getNumPages() const;
+		size_t getGpuBytes() const;
+
+		// Page area taken by a region, padding included
+		static size_t GetRegionBytes(const Region& region);
+
+		// SDL_PIXELFORMAT_* matching the page storage, surfaces in this format upload without conversion
+		static uint32_t GetPixelFormat();
+
+	private:
+		struct SkylineNode
+		{
+			int x;
+			int y;
+			int width;
+		};
+
+		struct Page
+		{
+			uint32_t textureId = 0;
+			int width = 0;
+			int height = 0;
+			size_t numRegions = 0;
+			std::vector<SkylineNode> skyline;
+		};
+
+		Page& createPage(int width, int height);
+		int findPosition(const Page& page, int width, int height, int& x, int& y) const;
+		int getSkylineFitY(const Page& page, size_t nodeIndex, int width, int height) const;
+		void commitAllocation(Page& page, size_t nodeIndex, int x, int y, int width, int height);
+
+		int _pageSize = 0;
+		std::vector<Page> _pages;
+		std::vector<uint32_t> _uploadBuffer;
+	};
+}
@@ -0,0 +1,183 @@
+//
+// SDLTextureLoader.cpp
+//
+// @author Roberto Cano
+//
+
+#include "SDLTextureLoader.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include <sdl/SDL.h>
+#include <sdl/SDL_image.h>
+
+using namespace SDL;
+
+namespace TextureLoaderConstants
+{
+	const unsigned char PngSignature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	const char PngHeaderChunk[] = { 'I', 'H', 'D', 'R' };
+	const size_t PngHeaderSize = 24;
+	const size_t PngChunkTypeOffset = 12;
+	const size_t PngWidthOffset = 16;
+	const size_t PngHeightOffset = 20;
+}
+
+namespace
+{
+	uint32_t ReadBigEndian32(const unsigned char* data)
+	{
+		return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+			(static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+	}
+}
+
+TextureLoader::TextureLoader(uint32_t numThreads, uint32_t targetPixelFormat)
+	: _targetPixelFormat(targetPixelFormat)
+{
+	for (uint32_t i = 0; i < numThreads; ++i) {
+		_workers.emplace_back(&TextureLoader::workerLoop, this);
+	}
+}
+
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isShuttingDown = true;
+	}
+	_requestAvailable.notify_all();
+
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+
+	for (Result& result : _results) {
+		SDL_FreeSurface(result.surface);
+	}
+}
+
+void TextureLoader::request(uint32_t requestId, const std::string& path)
+{
+	if (_workers.empty()) {
+		Result result = Load(requestId, path, _targetPixelFormat);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_results.push_back(std::move(result));
+		_numInFlight++;
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_requests.push_back(Request{ requestId, path });
+		_numInFlight++;
+	}
+	_requestAvailable.notify_one();
+}
+
+bool TextureLoader::tryPopResult(Result& result)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_results.empty()) {
+		return false;
+	}
+
+	result = std::move(_results.front());
+	_results.pop_front();
+	_numInFlight--;
+	return true;
+}
+
+bool TextureLoader::waitPopResult(Result& result)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_numInFlight == 0) {
+		return false;
+	}
+
+	_resultAvailable.wait(lock, [this] { return !_results.empty(); });
+
+	result = std::move(_results.front());
+	_results.pop_front();
+	_numInFlight--;
+	return true;
+}
+
+size_t TextureLoader::getNumInFlight() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _numInFlight;
+}
+
+bool TextureLoader::ReadImageSize(const std::string& path, int& width, int& height)
+{
+	using namespace TextureLoaderConstants;
+
+	unsigned char header[PngHeaderSize];
+
+	std::ifstream file(path, std::ios::binary);
+	file.read(reinterpret_cast<char*>(header), PngHeaderSize);
+
+	if (static_cast<size_t>(file.gcount()) != PngHeaderSize ||
+		!std::equal(std::begin(PngSignature), std::end(PngSignature), header) ||
+		!std::equal(std::begin(PngHeaderChunk), std::end(PngHeaderChunk), header + PngChunkTypeOffset)) {
+		return false;
+	}
+
+	width = static_cast<int>(ReadBigEndian32(header + PngWidthOffset));
+	height = static_cast<int>(ReadBigEndian32(header + PngHeightOffset));
+	return true;
+}
+
+TextureLoader::Result TextureLoader::Load(uint32_t requestId, const std::string& path, uint32_t targetPixelFormat)
+{
+	Result result;
+	result.requestId = requestId;
+
+	SDL_Surface* decoded = IMG_Load(path.c_str());
+	if (decoded == nullptr) {
+		result.error = std::string("Unable to load texture ") + path;
+		return result;
+	}
+
+	result.sourcePixelFormat = decoded->format->format;
+
+	// Converting here keeps the upload on the render thread down to a copy
+	result.surface = SDL_ConvertSurfaceFormat(decoded, targetPixelFormat, 0);
+	SDL_FreeSurface(decoded);
+
+	if (result.surface == nullptr) {
+		result.error = std::string("Unable to convert texture ") + path + ": " + SDL_GetError();
+	}
+
+	return result;
+}
+
+void TextureLoader::workerLoop()
+{
+	while (true) {
+		Request request;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_requestAvailable.wait(lock, [this] { return _isShuttingDown || !_requests.empty(); });
+
+			if (_isShuttingDown) {
+				return;
+			}
+
+			request = std::move(_requests.front());
+			_requests.pop_front();
+		}
+
+		Result result = Load(request.requestId, request.path, _targetPixelFormat);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_results.push_back(std::move(result));
+		}
+		_resultAvailable.notify_all();
+	}
+}
@@ -0,0 +1,73 @@
+//
+// SDLTextureLoader.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+struct SDL_Surface;
+
+namespace SDL
+{
+	//
+	// Decodes images on a pool of worker threads. Results are collected by the owner, which is
+	// the only one allowed to touch GL. With zero threads requests are decoded on the spot
+	//
+	class TextureLoader final
+	{
+	public:
+		struct Result
+		{
+			uint32_t requestId = 0;
+			SDL_Surface* surface = nullptr;	// In the target pixel format, owned by the receiver
+			uint32_t sourcePixelFormat = 0;
+			std::string error;
+		};
+
+		TextureLoader(uint32_t numThreads, uint32_t targetPixelFormat);
+		~TextureLoader();
+
+		TextureLoader(const TextureLoader&) = delete;
+		TextureLoader& operator=(const TextureLoader&) = delete;
+
+		void request(uint32_t requestId, const std::string& path);
+
+		bool tryPopResult(Result& result);
+		// Blocks until a result is ready, returns false when nothing is in flight
+		bool waitPopResult(Result& result);
+
+		size_t getNumInFlight() const;
+
+		// Reads the size from the PNG header without decoding, false for any other format
+		static bool ReadImageSize(const std::string& path, int& width, int& height);
+		static Result Load(uint32_t requestId, const std::string& path, uint32_t targetPixelFormat);
+
+	private:
+		struct Request
+		{
+			uint32_t requestId;
+			std::string path;
+		};
+
+		void workerLoop();
+
+		uint32_t _targetPixelFormat = 0;
+		std::vector<std::thread> _workers;
+		mutable std::mutex _mutex;
+		std::condition_variable _requestAvailable;
+		std::condition_variable _resultAvailable;
+		std::deque<Request> _requests;
+		std::deque<Result> _results;
+		size_t _numInFlight = 0;
+		bool _isShuttingDown = false;
+	};
+}
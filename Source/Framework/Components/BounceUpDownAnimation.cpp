@@ -7,12 +7,12 @@
 #include "BounceUpDownAnimation.hpp"
 
 #include "Framework/Core/GameObject.hpp"
+#include "Framework/Utils/Random.hpp"
 
 using namespace Framework::Components;
 
 namespace BounceUpDownAnimationConstants
 {
-	const float BouncePercentage = 0.5f;
 	const float Acceleration = 1900.0f;
 	const float FallExtraOfsset = 25.0f;
 }
@@ -33,13 +33,16 @@ BounceUpDownAnimation::BounceUpDownAnimation(const Config& config)
 	initialize(config);
 }
 
+BounceUpDownAnimation::~BounceUpDownAnimation()
+{
+	stopAnimation();
+}
+
 void BounceUpDownAnimation::initialize(const Config& config)
 {
 	_config = config;
 
-	_randomGenerator = std::make_unique<RandomGenerator>(0, 200);
-
-	_delay = _randomGenerator->getValue() / 1000.0f;
+	_delay = Framework::Utils::Random::Get().nextInt(0, 200) / 1000.0f;
 }
 
 void BounceUpDownAnimation::setOnFinishedCallback(const Callback& onFinished)
@@ -54,127 +57,122 @@ const BounceUpDownAnimation::Callback& BounceUpDownAnimation::getOnFinishedCallb
 
 void BounceUpDownAnimation::run()
 {
-	startAnimation();
+	if (hasOwner())
+	{
+		startAnimation();
+	}
+	else
+	{
+		_state = State::Pending;
+	}
 }
 
-void BounceUpDownAnimation::update(float dt)
+void BounceUpDownAnimation::cancel()
 {
-	switch (_state)
+	if (_state != State::Stopped)
 	{
-		case State::Stopped:
-		{
-			// Empty on purpose
-			break;
-		}
-		case State::Delay:
-		{
-			_animationTime += dt;
-			if (_animationTime >= _delay)
-			{
-				_state = State::Fall;
-
-				_animationTime = 0.0f;
-				_startPositionForAnimation = getOwner().getLocalPosition();
-			}
-			break;
-		}
-		case State::Fall:
-		{
-			if (!updateFall(dt))
-			{
-				_state = State::BounceUp;
-
-				_animationTime = 0.0f;
-				_startPositionForAnimation = getOwner().getLocalPosition();
-			}
-			break;
-		}
-		case State::BounceUp:
-		{
-			if (!updateBounceUp(dt))
-			{
-				_state = State::Finished;
-			}
-			break;
-		}
-		case State::Finished:
-		{
-			stopAnimation();
-			break;
-		}
+		stopAnimation();
+		onAnimationFinished();
 	}
 }
 
-void BounceUpDownAnimation::cancel()
+void BounceUpDownAnimation::_setOwner(Framework::Core::GameObject* gameObject)
 {
-	stopAnimation();
+	GameComponent::_setOwner(gameObject);
+
+	if (gameObject == nullptr)
+	{
+		// The tracks would keep moving an object we do not belong to anymore
+		stopAnimation();
+	}
+	else if (_state == State::Pending)
+	{
+		startAnimation();
+	}
 }
 
 void BounceUpDownAnimation::startAnimation()
 {
 	using namespace BounceUpDownAnimationConstants;
 
-	_animationTime = 0.0f;
-	Direction2D pathDirection = _config.end - _config.start;
-	_normDirection = glm::normalize(pathDirection);
-	_startPositionForAnimation = _config.start;
-	_bounceDuration = BouncePercentage * glm::length(pathDirection) / _config.speed;
-
-	_state = State::Delay;
-}
-
-void BounceUpDownAnimation::stopAnimation()
-{
-	_animationTime = 0.0f;
+	stopAnimation();
 
-	_state = State::Stopped;
+	// Thrown back at speed against the acceleration, s(t) = -speed * t + a * t^2 / 2, down to
+	// the overshot end. Normalized to the fall time that is the quadratic easing with slope
+	// -speed * fallTime / fallLength
+	const Direction2D pathDirection = _config.end - _config.start;
+	const Direction2D normDirection = glm::normalize(pathDirection);
+	const Point2D fallEnd = _config.end + FallExtraOfsset * normDirection;
+	const float fallLength = glm::length(fallEnd - _config.start);
+	const float fallTime = (_config.speed + glm::sqrt(_config.speed * _config.speed + 2.0f * Acceleration * fallLength)) / Acceleration;
+
+	// Pulled back up with four times the acceleration, from rest
+	const float bounceTime = glm::sqrt(FallExtraOfsset / (2.0f * Acceleration));
+
+	AnimationSystem::Tween fall;
+	fall.duration = fallTime;
+	fall.delay = _delay;
+	fall.easing = AnimationSystem::Easing::Quadratic;
+	fall.easingSlope = -_config.speed * fallTime / fallLength;
+
+	AnimationSystem::Tween bounce;
+	bounce.duration = bounceTime;
+	bounce.delay = _delay + fallTime;
+	bounce.easing = AnimationSystem::Easing::EaseInQuad;
+
+	AnimationSystem& animationSystem = AnimationSystem::Get();
+	Framework::Core::GameObject& owner = getOwner();
+
+	fall.property = AnimationSystem::Property::PositionX;
+	fall.from = _config.start.x;
+	fall.to = fallEnd.x;
+	_tracks.push_back(animationSystem.play(owner, fall));
+
+	fall.property = AnimationSystem::Property::PositionY;
+	fall.from = _config.start.y;
+	fall.to = fallEnd.y;
+	_tracks.push_back(animationSystem.play(owner, fall));
+
+	bounce.property = AnimationSystem::Property::PositionX;
+	bounce.from = fallEnd.x;
+	bounce.to = _config.end.x;
+	_tracks.push_back(animationSystem.play(owner, bounce));
+
+	bounce.property = AnimationSystem::Property::PositionY;
+	bounce.from = fallEnd.y;
+	bounce.to = _config.end.y;
+	_tracks.push_back(animationSystem.play(owner, bounce, [this](AnimationSystem::TrackId)
+	{
+		_tracks.clear();
+		onAnimationFinished();
+	}));
 
-	_userCallback(*this);
+	_state = State::Running;
 }
 
-bool BounceUpDownAnimation::updateBounceUp(float dt)
+void BounceUpDownAnimation::stopAnimation()
 {
-	using namespace BounceUpDownAnimationConstants;
-
-	_animationTime += dt;
-
-	Direction2D velocity = -_normDirection * (4.0f * Acceleration * _animationTime * _animationTime / 2.0f);
-	Point2D newPosition = _startPositionForAnimation + velocity;
-
-	if (glm::length(velocity) > glm::length(_config.end - _startPositionForAnimation))
+	AnimationSystem& animationSystem = AnimationSystem::Get();
+	for (AnimationSystem::TrackId track : _tracks)
 	{
-		getOwner().setLocalPosition(_config.end);
-
-		return false;
+		animationSystem.stop(track);
 	}
-	else
-	{
-		getOwner().setLocalPosition(newPosition);
+	_tracks.clear();
 
-		return true;
+	if (_state == State::Running)
+	{
+		_state = State::Stopped;
 	}
 }
 
-bool BounceUpDownAnimation::updateFall(float dt)
+void BounceUpDownAnimation::onAnimationFinished()
 {
-	using namespace BounceUpDownAnimationConstants;
-
-	_animationTime += dt;
-
-	Direction2D velocity = _normDirection * ((-_config.speed * _animationTime) + (Acceleration * _animationTime * _animationTime / 2.0f));
-	Point2D newPosition = _startPositionForAnimation + velocity;
-
-	Point2D endPosition = _config.end + FallExtraOfsset * _normDirection;
-	if (glm::length(velocity) > glm::length(endPosition - _startPositionForAnimation))
-	{
-		getOwner().setLocalPosition(endPosition);
+	_state = State::Stopped;
 
-		return false;
-	}
-	else
+	// Copied, the callback usually removes and thus destroys us
+	Callback userCallback = _userCallback;
+	if (userCallback)
 	{
-		getOwner().setLocalPosition(newPosition);
-
-		return true;
+		userCallback(*this);
 	}
 }
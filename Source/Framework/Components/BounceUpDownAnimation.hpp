@@ -8,6 +8,7 @@
 
 #include "Framework/Core/GameComponent.hpp"
 #include "Framework/Core/Types.hpp"
+#include "Framework/Core/AnimationSystem.hpp"
 #include "Framework/Utils/Utils.hpp"
 
 #include <functional>
@@ -16,6 +17,11 @@ namespace Framework
 {
 	namespace Components
 	{
+		//
+		// Drops its owner from start to end, overshooting a bit and bouncing back. The motion is a
+		// handful of tracks in the AnimationSystem, started once the component has an owner, so the
+		// component itself is never updated
+		//
 		class BounceUpDownAnimation : public Framework::Core::GameComponent
 		{
 		public:
@@ -33,7 +39,7 @@ namespace Framework
 
 			BounceUpDownAnimation(const Point2D& start, const Point2D& end, float speed);
 			BounceUpDownAnimation(const Config& config);
-			~BounceUpDownAnimation() = default;
+			~BounceUpDownAnimation() override;
 
 			void setOnFinishedCallback(const Callback& onFinished);
 			const Callback& getOnFinishedCallback() const;
@@ -41,40 +47,31 @@ namespace Framework
 			void run();
 			void cancel();
 
-			// GameComponent life cycle
-			void update(float dt) override;
+		protected:
+			void _setOwner(Framework::Core::GameObject* gameObject) override;
 
 		private:
+			using AnimationSystem = Framework::Core::AnimationSystem;
+
 			enum class State
 			{
 				Stopped,
-				Delay,
-				Fall,
-				BounceUp,
-				Finished
+				Pending,	// Waiting for an owner
+				Running
 			};
-			using AnimationState = AnimationData;
 
 			void initialize(const Config& config);
 
 			void startAnimation();
-			bool updateBounceUp(float dt);
-			bool updateFall(float dt);
 			void stopAnimation();
+			void onAnimationFinished();
 
 			Config _config;
 			Callback _userCallback;
-			Types::GameObject::PtrType _owner;
 
-			float _animationTime = 0.0f;
-			Point2D _normDirection;
-			Point2D _startPositionForAnimation;
 			State _state = State::Stopped;
 			float _delay = 0.0f;
-			float _bounceDuration = 0.0f;
-
-			using RandomGenerator = Framework::Utils::RandomGenerator;
-			std::unique_ptr<RandomGenerator> _randomGenerator;
+			std::vector<AnimationSystem::TrackId> _tracks;
 		};
 	}
 }
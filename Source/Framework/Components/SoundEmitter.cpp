@@ -8,6 +8,7 @@
 
 #include "Framework/Core/Engine.hpp"
 #include "Framework/Core/GameObject.hpp"
+#include "Framework/Core/AnimationSystem.hpp"
 #include "Framework/Core/Types.hpp"
 
 using namespace Framework::Components;
@@ -15,14 +16,30 @@ using namespace Framework::Components;
 namespace SoundEmitterConstants
 {
 	const float AnimationDuration = 0.4f;
+	// Grows in, holds and shrinks out, each fade taking this much of the animation
+	const float FadeDuration = AnimationDuration / 2.5f;
 	const float FinalScale = 0.4f;
 	const Framework::Types::Color3D TextColor(1.0f, 0.3f, 0.6);
 	const Framework::Types::Point2D Offset(50.0f, -25.0f);
 }
 
+SoundEmitter::~SoundEmitter()
+{
+	stopPulseAnimation();
+
+	if (_textLayoutId != Core::Engine::InvalidTextLayoutId && hasEngine())
+	{
+		getEngine()->releaseTextLayout(_textLayoutId);
+	}
+}
+
 void SoundEmitter::setVisualDescription(const std::string& description)
 {
-	_visualDescription = description;
+	if (description != _visualDescription)
+	{
+		_visualDescription = description;
+		_isTextLayoutDirty = true;
+	}
 }
 
 const std::string& SoundEmitter::getVisualDescription() const
@@ -45,7 +62,7 @@ void SoundEmitter::play()
 	_newState = State::Playing;
 }
 
-void SoundEmitter::update(float dt)
+void SoundEmitter::update(float /* dt */)
 {
 	if (_newState != _state)
 	{
@@ -54,6 +71,7 @@ void SoundEmitter::update(float dt)
 		if (_state == State::Playing)
 		{
 			_currentRotation = _rotation;
+			startPulseAnimation();
 		}
 	}
 
@@ -66,41 +84,75 @@ void SoundEmitter::update(float dt)
 		}
 		case State::Playing:
 		{
-			if (!updateVisualDescriptionAnimation(dt))
-			{
-				_newState = State::Stopped;
-			}
+			renderVisualDescription();
 			break;
 		}
 	}
 }
 
-bool SoundEmitter::updateVisualDescriptionAnimation(float dt)
+void SoundEmitter::updateTextLayout()
 {
-	_animationTime += dt;
-
-	if (_animationTime > SoundEmitterConstants::AnimationDuration)
+	if (!_isTextLayoutDirty)
 	{
-		_animationTime = 0.0f;
-		return false;
+		return;
 	}
 
-	Framework::Core::GameObject& owner = getOwner<Framework::Core::GameObject>();
-	float factor = _animationTime / (SoundEmitterConstants::AnimationDuration / 2.5f);
-
-	if (factor > 1.5f)
+	if (_textLayoutId == Core::Engine::InvalidTextLayoutId)
 	{
-		factor = 2.5f - factor;
+		_textLayoutId = getEngine()->createTextLayout(_visualDescription);
 	}
-	else if (factor > 1.0f)
+	else
 	{
-		factor = 1.0f;
+		getEngine()->updateTextLayout(_textLayoutId, _visualDescription);
 	}
+	_isTextLayoutDirty = false;
+}
 
-	Point2D worldPosition = owner.getWorldPosition() + SoundEmitterConstants::Offset;
+void SoundEmitter::startPulseAnimation()
+{
+	using namespace SoundEmitterConstants;
+	using AnimationSystem = Framework::Core::AnimationSystem;
+
+	AnimationSystem& animationSystem = AnimationSystem::Get();
+	Framework::Core::GameObject& owner = getOwner<Framework::Core::GameObject>();
+
+	stopPulseAnimation();
+
+	AnimationSystem::Tween grow;
+	grow.to = 1.0f;
+	grow.duration = FadeDuration;
+
+	AnimationSystem::Tween shrink;
+	shrink.from = 1.0f;
+	shrink.duration = FadeDuration;
+	shrink.delay = AnimationDuration - FadeDuration;
 
-	getEngine()->renderText(_visualDescription, worldPosition, owner.getZIndex() + 1, SoundEmitterConstants::TextColor,
-		_currentRotation, factor * SoundEmitterConstants::FinalScale, factor);
+	_growTrack = animationSystem.play(owner, _pulse, grow);
+	_shrinkTrack = animationSystem.play(owner, _pulse, shrink, [this](AnimationSystem::TrackId)
+	{
+		// Stopped right away, a play() later this frame starts it over
+		_state = State::Stopped;
+		_newState = State::Stopped;
+	});
+}
+
+void SoundEmitter::stopPulseAnimation()
+{
+	using AnimationSystem = Framework::Core::AnimationSystem;
 
-	return true;
-}
\ No newline at end of file
+	AnimationSystem& animationSystem = AnimationSystem::Get();
+	animationSystem.stop(_growTrack);
+	animationSystem.stop(_shrinkTrack);
+	_growTrack = AnimationSystem::InvalidTrack;
+	_shrinkTrack = AnimationSystem::InvalidTrack;
+}
+
+void SoundEmitter::renderVisualDescription()
+{
+	Framework::Core::GameObject& owner = getOwner<Framework::Core::GameObject>();
+	Point2D worldPosition = owner.getWorldPosition() + SoundEmitterConstants::Offset;
+
+	updateTextLayout();
+	getEngine()->renderTextLayout(_textLayoutId, worldPosition, owner.getZIndex() + 1, SoundEmitterConstants::TextColor,
+		_currentRotation, _pulse * SoundEmitterConstants::FinalScale, _pulse);
+}
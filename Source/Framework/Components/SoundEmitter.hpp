@@ -7,6 +7,8 @@
 #pragma once
 
 #include "Framework/Core/GameComponent.hpp"
+#include "Framework/Core/Engine.hpp"
+#include "Framework/Core/AnimationSystem.hpp"
 
 namespace Framework
 {
@@ -16,7 +18,7 @@ namespace Framework
 		{
 		public:
 			SoundEmitter() = default;
-			~SoundEmitter() override = default;
+			~SoundEmitter() override;
 
 			void setVisualDescription(const std::string& description);
 			const std::string& getVisualDescription() const;
@@ -35,11 +37,19 @@ namespace Framework
 				Playing
 			};
 
-			bool updateVisualDescriptionAnimation(float dt);
+			void updateTextLayout();
+			// The scale and opacity of the text are tracks in the AnimationSystem
+			void startPulseAnimation();
+			void stopPulseAnimation();
+			void renderVisualDescription();
 
 			std::string _visualDescription;
+			Types::TextLayoutId _textLayoutId = Core::Engine::InvalidTextLayoutId;
+			bool _isTextLayoutDirty = true;
 
-			float _animationTime = 0.0f;
+			float _pulse = 0.0f;
+			Core::AnimationSystem::TrackId _growTrack = Core::AnimationSystem::InvalidTrack;
+			Core::AnimationSystem::TrackId _shrinkTrack = Core::AnimationSystem::InvalidTrack;
 			float _rotation = 0.0f;
 			float _currentRotation = 0.0f;
 			State _state = State::Stopped;
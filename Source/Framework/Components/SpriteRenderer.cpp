@@ -19,6 +19,7 @@ using namespace Framework::Types;
 namespace SpriteRendererConstants
 {
 	const Point2D RendererDefaultAnchorPoint = Point2D(0.5f, 0.5f);
+	const TextureId InvalidSpriteId = static_cast<TextureId>(-1);
 }
 
 Components::SpriteRenderer::SpriteRenderer(const std::string& assetPath)
@@ -27,6 +28,11 @@ Components::SpriteRenderer::SpriteRenderer(const std::string& assetPath)
 	// Empty on purpose
 }
 
+Components::SpriteRenderer::~SpriteRenderer()
+{
+	releaseSprite();
+}
+
 TextureId Components::SpriteRenderer::getSpriteId() const
 {
 	return _id;
@@ -70,6 +76,11 @@ float Components::SpriteRenderer::getOpacity() const
 	return _opacity;
 }
 
+float& Components::SpriteRenderer::getOpacityTarget()
+{
+	return _opacity;
+}
+
 void Components::SpriteRenderer::setScale(float scale)
 {
 	_scale = scale;
@@ -102,9 +113,19 @@ int Components::SpriteRenderer::getZIndexOffset() const
 
 void Components::SpriteRenderer::setSprite(const std::string& assetPath)
 {
-	_assetPath = assetPath;
+	using namespace SpriteRendererConstants;
+
+	if (_id != InvalidSpriteId && assetPath == _assetPath)
+	{
+		return;
+	}
+
+	// Register first so switching between sprites sharing a texture never drops its last reference
+	const TextureId newId = getEngine()->registerTexture(assetPath);
+	releaseSprite();
 
-	_id = getEngine()->registerTexture(_assetPath);
+	_assetPath = assetPath;
+	_id = newId;
 	_size = getEngine()->getTextureSize(_id);
 }
 
@@ -113,20 +134,32 @@ const std::string& Components::SpriteRenderer::getSprite()
 	return _assetPath;
 }
 
+void Components::SpriteRenderer::releaseSprite()
+{
+	using namespace SpriteRendererConstants;
+
+	if (_id != InvalidSpriteId && hasEngine())
+	{
+		getEngine()->releaseTexture(_id);
+		_id = InvalidSpriteId;
+	}
+}
+
 void Components::SpriteRenderer::renderSprite()
 {
 	using namespace SpriteRendererConstants;
 
 	const Core::GameObject& gameObject = getOwner();
 
-	const Point2D& goWorldPosition = gameObject.getWorldPosition();
-
 	const Size2D spriteSize = _size;
 	const Point2D anchorPoint = getAnchorPoint();
 
 	Point2D anchorOffset = (RendererDefaultAnchorPoint - anchorPoint) * spriteSize;
 
-	const Point2D renderPosition = goWorldPosition + anchorOffset;
+	// World values are cached by the transform pass, nothing is rebuilt per sprite
+	const Point2D renderPosition = gameObject.localToWorld(anchorOffset);
+	const float rotation = gameObject.getWorldRotation() + _rotation;
+	const float scale = gameObject.getWorldScale() * _scale;
 
-	getEngine()->render(_id, renderPosition, gameObject.getZIndex() + _zIndexOffset, Color3D(1.0f, 1.0f, 1.0f), _rotation, _scale, _opacity);
+	getEngine()->render(_id, renderPosition, gameObject.getZIndex() + _zIndexOffset, Color3D(1.0f, 1.0f, 1.0f), rotation, scale, _opacity);
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include "Framework/Core/Types.hpp"
 #include "Framework/Core/GameComponent.hpp"
+#include "Framework/Core/ComponentPool.hpp"
 #include "Framework/Core/AnchorPointUser.hpp"
 #include "CodeExecution.hpp"
 
@@ -20,6 +21,7 @@ namespace Framework
 		{
 		public:
 			SpriteRenderer(const std::string& assetPath);
+			~SpriteRenderer() override;
 
 			TextureId getSpriteId() const;
 
@@ -37,6 +39,8 @@ namespace Framework
 
 			void setOpacity(float opacity);
 			float getOpacity() const;
+			// Lets an AnimationSystem track fade the sprite, see AnimationSystem::play()
+			float& getOpacityTarget();
 
 			void setScale(float scale);
 			float getScale() const;
@@ -49,6 +53,7 @@ namespace Framework
 
 		private:
 			void renderSprite();
+			void releaseSprite();
 
 			std::string _assetPath;
 			TextureId _id = -1;
@@ -61,5 +66,20 @@ namespace Framework
 			int _zIndexOffset = 0;
 		};
 	}
+
+	namespace Core
+	{
+		// Usually the most numerous component, so sprites are stored and drawn from a single pool
+		template<>
+		struct UsesComponentPool<Components::SpriteRenderer> : std::true_type {};
+
+		// Drawing only reads the owner, so the slabs are submitted from several threads at once
+		template<>
+		struct ComponentUpdatePolicy<Components::SpriteRenderer>
+		{
+			static constexpr UpdatePhase Phase = UpdatePhase::RenderSubmit;
+			static constexpr bool IsParallel = true;
+		};
+	}
 }
 
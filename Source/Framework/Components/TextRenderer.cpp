@@ -13,6 +13,14 @@
 
 using namespace Framework::Components;
 
+TextRenderer::~TextRenderer()
+{
+	if (_textLayoutId != Core::Engine::InvalidTextLayoutId && hasEngine())
+	{
+		getEngine()->releaseTextLayout(_textLayoutId);
+	}
+}
+
 void TextRenderer::setRotation(float rotation)
 {
 	_rotation = rotation;
@@ -55,7 +63,11 @@ const TextRenderer::Point2D & TextRenderer::getPosition() const
 
 void TextRenderer::setText(const std::string& description)
 {
-	_text = description;
+	if (description != _text)
+	{
+		_text = description;
+		_isTextLayoutDirty = true;
+	}
 }
 
 const std::string& TextRenderer::getText() const
@@ -78,12 +90,33 @@ void TextRenderer::update(float dt)
 	renderText();
 }
 
+void TextRenderer::updateTextLayout()
+{
+	if (!_isTextLayoutDirty)
+	{
+		return;
+	}
+
+	if (_textLayoutId == Core::Engine::InvalidTextLayoutId)
+	{
+		_textLayoutId = getEngine()->createTextLayout(_text);
+	}
+	else
+	{
+		getEngine()->updateTextLayout(_textLayoutId, _text);
+	}
+	_isTextLayoutDirty = false;
+}
+
 void TextRenderer::renderText()
 {
+	updateTextLayout();
+
 	const auto& owner = getOwner<Framework::Core::GameObject>();
 
-	const Point2D& parentPosition = owner.getWorldPosition();
-	const Point2D renderPosition = parentPosition + getPosition();
+	const Point2D renderPosition = owner.localToWorld(getPosition());
+	const float rotation = owner.getWorldRotation() + _rotation;
+	const float scale = owner.getWorldScale() * _scale;
 
-	getEngine()->renderText(_text, renderPosition, owner.getZIndex(), _color, _rotation, _scale, _opacity);
+	getEngine()->renderTextLayout(_textLayoutId, renderPosition, owner.getZIndex(), _color, rotation, scale, _opacity);
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Framework/Core/GameComponent.hpp"
+#include "Framework/Core/Engine.hpp"
 
 namespace Framework
 {
@@ -19,7 +20,7 @@ namespace Framework
 			using Color3D = Framework::Types::Color3D;
 
 			TextRenderer() = default;
-			~TextRenderer() override = default;
+			~TextRenderer() override;
 
 			void setRotation(float rotation);
 			float getRotation() const;
@@ -48,6 +49,7 @@ namespace Framework
 				Playing
 			};
 
+			void updateTextLayout();
 			void renderText();
 
 			// TODO: transform
@@ -58,6 +60,8 @@ namespace Framework
 			Color3D _color;
 
 			std::string _text;
+			Types::TextLayoutId _textLayoutId = Core::Engine::InvalidTextLayoutId;
+			bool _isTextLayoutDirty = true;
 		};
 	}
 }
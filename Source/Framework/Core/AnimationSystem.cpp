@@ -0,0 +1,368 @@
+//
+// AnimationSystem.cpp
+//
+// @author Roberto Cano
+//
+
+#include "AnimationSystem.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include "GameObject.hpp"
+
+using namespace Framework;
+using namespace Framework::Core;
+using namespace Framework::Types;
+
+namespace AnimationSystemConstants
+{
+	const float MinDuration = 0.0001f;
+	const uint32_t InvalidSlot = 0xFFFFFFFF;
+	const uint32_t FirstGeneration = 1;		// Keeps every valid track id away from InvalidTrack
+}
+
+namespace
+{
+	float Ease(AnimationSystem::Easing easing, float t, float slope)
+	{
+		switch (easing)
+		{
+			case AnimationSystem::Easing::Linear:
+			{
+				return t;
+			}
+			case AnimationSystem::Easing::EaseInQuad:
+			{
+				return t * t;
+			}
+			case AnimationSystem::Easing::EaseOutQuad:
+			{
+				return t * (2.0f - t);
+			}
+			case AnimationSystem::Easing::Quadratic:
+			{
+				return slope * t + (1.0f - slope) * t * t;
+			}
+		}
+		return t;
+	}
+}
+
+AnimationSystem& AnimationSystem::Get()
+{
+	static AnimationSystem animationSystem;
+	return animationSystem;
+}
+
+#pragma region - Tracks
+AnimationSystem::TrackId AnimationSystem::play(GameObject& target, const Tween& tween, Callback onFinished)
+{
+	assert(tween.property != Property::Value);
+	return playTween(target, tween.property, nullptr, tween, std::move(onFinished));
+}
+
+AnimationSystem::TrackId AnimationSystem::play(GameObject& target, float& value, const Tween& tween, Callback onFinished)
+{
+	return playTween(target, Property::Value, &value, tween, std::move(onFinished));
+}
+
+AnimationSystem::TrackId AnimationSystem::play(GameObject& target, const Oscillation& oscillation)
+{
+	assert(oscillation.property != Property::Value);
+
+	const TrackId track = addTrack(target, oscillation.property, Curve::Oscillation);
+	const uint32_t slot = static_cast<uint32_t>(_tracksBySlot.size() - 1);
+
+	_startTimes[slot] = _time;
+	_from[slot] = oscillation.base;
+	_to[slot] = oscillation.amplitude;
+	_rates[slot] = oscillation.angularSpeed;
+	_phases[slot] = oscillation.phase;
+
+	_values[slot] = oscillation.base + oscillation.amplitude * std::sin(oscillation.phase);
+	applyValue(slot);
+
+	return track;
+}
+
+void AnimationSystem::stop(TrackId track)
+{
+	const uint32_t slot = getSlot(track);
+	if (slot != AnimationSystemConstants::InvalidSlot)
+	{
+		removeSlot(slot);
+	}
+}
+
+void AnimationSystem::stopAll(const GameObject& target)
+{
+	// Backwards, the slot swapped into a removed one has already been looked at
+	for (size_t slot = _nodes.size(); slot-- > 0;)
+	{
+		if (_nodes[slot] == target._transformNode)
+		{
+			removeSlot(static_cast<uint32_t>(slot));
+		}
+	}
+}
+
+bool AnimationSystem::isPlaying(TrackId track) const
+{
+	return getSlot(track) != AnimationSystemConstants::InvalidSlot;
+}
+
+size_t AnimationSystem::getNumTracks() const
+{
+	return _tracksBySlot.size();
+}
+
+#pragma region - Update
+void AnimationSystem::update(float dt)
+{
+	_time += dt;
+
+	const size_t numTracks = _tracksBySlot.size();
+
+	for (size_t i = 0; i < numTracks; ++i)
+	{
+		_elapsed[i] = static_cast<float>(_time - _startTimes[i]);
+	}
+
+	for (size_t i = 0; i < numTracks; ++i)
+	{
+		if (_curves[i] == Curve::Tween)
+		{
+			const float t = std::min(std::max(_elapsed[i] / _durations[i], 0.0f), 1.0f);
+			_values[i] = _from[i] + (_to[i] - _from[i]) * Ease(_easings[i], t, _rates[i]);
+			_finishedFlags[i] = _elapsed[i] >= _durations[i];
+		}
+		else
+		{
+			_values[i] = _from[i] + _to[i] * std::sin(_phases[i] + _rates[i] * _elapsed[i]);
+		}
+	}
+
+	for (size_t i = 0; i < numTracks; ++i)
+	{
+		if (_elapsed[i] >= 0.0f)
+		{
+			applyValue(static_cast<uint32_t>(i));
+		}
+	}
+
+	removeFinishedTracks();
+
+	// Nothing is being walked anymore, callbacks are free to start, stop or destroy anything
+	std::vector<FinishedTrack> finishedTracks;
+	finishedTracks.swap(_finishedTracks);
+	for (FinishedTrack& finishedTrack : finishedTracks)
+	{
+		if (finishedTrack.onFinished)
+		{
+			finishedTrack.onFinished(finishedTrack.track);
+		}
+	}
+}
+
+#pragma region - Helpers
+AnimationSystem::TrackId AnimationSystem::addTrack(const GameObject& target, Property property, Curve curve)
+{
+	uint32_t index;
+	if (_freeIndices.empty())
+	{
+		index = static_cast<uint32_t>(_generations.size());
+		_generations.push_back(AnimationSystemConstants::FirstGeneration);
+		_slotsByIndex.push_back(AnimationSystemConstants::InvalidSlot);
+	}
+	else
+	{
+		index = _freeIndices.back();
+		_freeIndices.pop_back();
+	}
+
+	const TrackId track = (static_cast<TrackId>(_generations[index]) << 32) | index;
+	_slotsByIndex[index] = static_cast<uint32_t>(_tracksBySlot.size());
+
+	_startTimes.push_back(_time);
+	_durations.push_back(0.0f);
+	_from.push_back(0.0f);
+	_to.push_back(0.0f);
+	_rates.push_back(0.0f);
+	_phases.push_back(0.0f);
+	_curves.push_back(curve);
+	_easings.push_back(Easing::Linear);
+	_elapsed.push_back(0.0f);
+	_values.push_back(0.0f);
+	_finishedFlags.push_back(0);
+	_nodes.push_back(target._transformNode);
+	_properties.push_back(property);
+	_valueTargets.push_back(nullptr);
+	_tracksBySlot.push_back(track);
+	_callbacks.emplace_back();
+
+	return track;
+}
+
+AnimationSystem::TrackId AnimationSystem::playTween(GameObject& target, Property property, float* value, const Tween& tween, Callback onFinished)
+{
+	const TrackId track = addTrack(target, property, Curve::Tween);
+	const uint32_t slot = static_cast<uint32_t>(_tracksBySlot.size() - 1);
+
+	_valueTargets[slot] = value;
+	_startTimes[slot] = _time + tween.delay;
+	_durations[slot] = std::max(tween.duration, AnimationSystemConstants::MinDuration);
+	_from[slot] = tween.from;
+	_to[slot] = tween.to;
+	_rates[slot] = tween.easingSlope;
+	_easings[slot] = tween.easing;
+	_callbacks[slot] = std::move(onFinished);
+
+	// Delayed tracks leave the property alone until they begin
+	if (tween.delay <= 0.0f)
+	{
+		_values[slot] = tween.from;
+		applyValue(slot);
+	}
+
+	return track;
+}
+
+uint32_t AnimationSystem::getSlot(TrackId track) const
+{
+	const uint32_t index = static_cast<uint32_t>(track);
+	const uint32_t generation = static_cast<uint32_t>(track >> 32);
+	if (index >= _generations.size() || _generations[index] != generation)
+	{
+		return AnimationSystemConstants::InvalidSlot;
+	}
+
+	return _slotsByIndex[index];
+}
+
+void AnimationSystem::applyValue(uint32_t slot)
+{
+	TransformHierarchy& transformHierarchy = TransformHierarchy::Get();
+	const TransformHierarchy::NodeId node = _nodes[slot];
+	const float value = _values[slot];
+
+	switch (_properties[slot])
+	{
+		case Property::PositionX:
+		{
+			Point2D position = transformHierarchy.getLocalPosition(node);
+			position.x = value;
+			transformHierarchy.setLocalPosition(node, position);
+			break;
+		}
+		case Property::PositionY:
+		{
+			Point2D position = transformHierarchy.getLocalPosition(node);
+			position.y = value;
+			transformHierarchy.setLocalPosition(node, position);
+			break;
+		}
+		case Property::Rotation:
+		{
+			transformHierarchy.setLocalRotation(node, value);
+			break;
+		}
+		case Property::Scale:
+		{
+			transformHierarchy.setLocalScale(node, value);
+			break;
+		}
+		case Property::Value:
+		{
+			*_valueTargets[slot] = value;
+			break;
+		}
+	}
+}
+
+void AnimationSystem::moveSlot(uint32_t from, uint32_t to)
+{
+	_startTimes[to] = _startTimes[from];
+	_durations[to] = _durations[from];
+	_from[to] = _from[from];
+	_to[to] = _to[from];
+	_rates[to] = _rates[from];
+	_phases[to] = _phases[from];
+	_curves[to] = _curves[from];
+	_easings[to] = _easings[from];
+	_elapsed[to] = _elapsed[from];
+	_values[to] = _values[from];
+	_finishedFlags[to] = _finishedFlags[from];
+	_nodes[to] = _nodes[from];
+	_properties[to] = _properties[from];
+	_valueTargets[to] = _valueTargets[from];
+	_tracksBySlot[to] = _tracksBySlot[from];
+	_callbacks[to] = std::move(_callbacks[from]);
+
+	_slotsByIndex[static_cast<uint32_t>(_tracksBySlot[to])] = to;
+}
+
+void AnimationSystem::resizeSlots(size_t numSlots)
+{
+	_startTimes.resize(numSlots);
+	_durations.resize(numSlots);
+	_from.resize(numSlots);
+	_to.resize(numSlots);
+	_rates.resize(numSlots);
+	_phases.resize(numSlots);
+	_curves.resize(numSlots);
+	_easings.resize(numSlots);
+	_elapsed.resize(numSlots);
+	_values.resize(numSlots);
+	_finishedFlags.resize(numSlots);
+	_nodes.resize(numSlots);
+	_properties.resize(numSlots);
+	_valueTargets.resize(numSlots);
+	_tracksBySlot.resize(numSlots);
+	_callbacks.resize(numSlots);
+}
+
+void AnimationSystem::releaseTrack(TrackId track)
+{
+	const uint32_t index = static_cast<uint32_t>(track);
+	_generations[index]++;
+	_slotsByIndex[index] = AnimationSystemConstants::InvalidSlot;
+	_freeIndices.push_back(index);
+}
+
+void AnimationSystem::removeSlot(uint32_t slot)
+{
+	const uint32_t lastSlot = static_cast<uint32_t>(_tracksBySlot.size() - 1);
+
+	releaseTrack(_tracksBySlot[slot]);
+	if (slot != lastSlot)
+	{
+		moveSlot(lastSlot, slot);
+	}
+	resizeSlots(lastSlot);
+}
+
+void AnimationSystem::removeFinishedTracks()
+{
+	// One compaction for the whole frame, keeping the order of the survivors
+	const uint32_t numTracks = static_cast<uint32_t>(_tracksBySlot.size());
+	uint32_t numAlive = 0;
+	for (uint32_t slot = 0; slot < numTracks; ++slot)
+	{
+		if (_curves[slot] == Curve::Tween && _finishedFlags[slot])
+		{
+			_finishedTracks.push_back({ _tracksBySlot[slot], std::move(_callbacks[slot]) });
+			releaseTrack(_tracksBySlot[slot]);
+			continue;
+		}
+
+		if (slot != numAlive)
+		{
+			moveSlot(slot, numAlive);
+		}
+		numAlive++;
+	}
+
+	resizeSlots(numAlive);
+}
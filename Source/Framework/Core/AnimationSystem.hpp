@@ -0,0 +1,153 @@
+//
+// AnimationSystem.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include "Types.hpp"
+#include "TransformHierarchy.hpp"
+
+namespace Framework
+{
+	using namespace Types;
+	namespace Core
+	{
+		//
+		// Every running animation of the game as a track on one local transform property of a game
+		// object, or on a float the object owns such as the opacity of one of its renderers. Tracks
+		// are kept as parallel arrays and evaluated together once per frame, before the transform
+		// pass, so animated objects need no update of their own. A track either tweens between two
+		// values or oscillates around one until stopped.
+		//
+		// Finishing tweens are queued and their callbacks run once the whole pass is done, so a callback
+		// may start, stop or destroy anything. Stopped tracks never call back
+		//
+		class AnimationSystem final
+		{
+		public:
+			using TrackId = uint64_t;
+			static constexpr TrackId InvalidTrack = 0;
+
+			using Callback = std::function<void(TrackId)>;
+
+			enum class Property : uint8_t
+			{
+				PositionX,
+				PositionY,
+				Rotation,
+				Scale,
+				// A float of the target, set by the play() overloads that take one
+				Value
+			};
+
+			enum class Easing : uint8_t
+			{
+				Linear,
+				EaseInQuad,
+				EaseOutQuad,
+				// p * t + (1 - p) * t^2, p being the initial slope. Covers a body thrown with a
+				// constant acceleration, see BounceUpDownAnimation
+				Quadratic
+			};
+
+			struct Tween
+			{
+				Property property = Property::PositionX;
+				float from = 0.0f;
+				float to = 0.0f;
+				float duration = 0.0f;
+				float delay = 0.0f;
+				Easing easing = Easing::Linear;
+				float easingSlope = 0.0f;	// Only for Easing::Quadratic
+			};
+
+			struct Oscillation
+			{
+				Property property = Property::PositionX;
+				float base = 0.0f;
+				float amplitude = 0.0f;
+				float angularSpeed = 0.0f;	// rad/sec
+				float phase = 0.0f;
+			};
+
+			static AnimationSystem& Get();
+
+			AnimationSystem(const AnimationSystem&) = delete;
+			AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+			TrackId play(GameObject& target, const Tween& tween, Callback onFinished = nullptr);
+			// Drives value instead of a transform property, the tween property is ignored. The value
+			// must live until the track ends, stopAll() on the target stops it with the rest
+			TrackId play(GameObject& target, float& value, const Tween& tween, Callback onFinished = nullptr);
+			// base + amplitude * sin(phase + angularSpeed * t), until stopped
+			TrackId play(GameObject& target, const Oscillation& oscillation);
+
+			// The property keeps its current value
+			void stop(TrackId track);
+			void stopAll(const GameObject& target);
+			bool isPlaying(TrackId track) const;
+
+			void update(float dt);
+
+			size_t getNumTracks() const;
+
+		private:
+			enum class Curve : uint8_t
+			{
+				Tween,
+				Oscillation
+			};
+
+			struct FinishedTrack
+			{
+				TrackId track;
+				Callback onFinished;
+			};
+
+			AnimationSystem() = default;
+
+			TrackId addTrack(const GameObject& target, Property property, Curve curve);
+			TrackId playTween(GameObject& target, Property property, float* value, const Tween& tween, Callback onFinished);
+			uint32_t getSlot(TrackId track) const;
+			void applyValue(uint32_t slot);
+			void moveSlot(uint32_t from, uint32_t to);
+			void resizeSlots(size_t numSlots);
+			void releaseTrack(TrackId track);
+			void removeSlot(uint32_t slot);
+			void removeFinishedTracks();
+
+			double _time = 0.0;
+
+			// Indexed by slot, live tracks are packed at the front
+			std::vector<double> _startTimes;
+			std::vector<float> _durations;
+			std::vector<float> _from;
+			std::vector<float> _to;
+			std::vector<float> _rates;		// Easing slope or angular speed
+			std::vector<float> _phases;
+			std::vector<Curve> _curves;
+			std::vector<Easing> _easings;
+			std::vector<float> _elapsed;
+			std::vector<float> _values;
+			std::vector<uint8_t> _finishedFlags;
+			std::vector<TransformHierarchy::NodeId> _nodes;
+			std::vector<Property> _properties;
+			std::vector<float*> _valueTargets;		// Only for Property::Value
+			std::vector<TrackId> _tracksBySlot;
+			std::vector<Callback> _callbacks;
+
+			// Indexed by the low half of a track id, the high half is its generation
+			std::vector<uint32_t> _slotsByIndex;
+			std::vector<uint32_t> _generations;
+			std::vector<uint32_t> _freeIndices;
+
+			std::vector<FinishedTrack> _finishedTracks;
+		};
+	}
+}
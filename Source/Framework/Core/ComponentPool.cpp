@@ -0,0 +1,28 @@
+//
+// ComponentPool.cpp
+//
+// @author Roberto Cano
+//
+
+#include "ComponentPool.hpp"
+
+using namespace Framework::Core;
+
+namespace
+{
+	std::vector<ComponentPoolBase*>& GetRegisteredPools()
+	{
+		static std::vector<ComponentPoolBase*> pools;
+		return pools;
+	}
+}
+
+const std::vector<ComponentPoolBase*>& ComponentPoolBase::GetAllPools()
+{
+	return GetRegisteredPools();
+}
+
+void ComponentPoolBase::RegisterPool(ComponentPoolBase& pool)
+{
+	GetRegisteredPools().push_back(&pool);
+}
@@ -0,0 +1,201 @@
+//
+// ComponentPool.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <cassert>
+
+#include "Types.hpp"
+
+namespace Framework
+{
+	namespace Core
+	{
+		//
+		// Opt-in for pooled storage, specialise it next to the component declaration:
+		//
+		//     template<> struct UsesComponentPool<Components::SpriteRenderer> : std::true_type {};
+		//
+		// Pooled components live side by side in their type's pool and are updated by walking the pool
+		// once per frame, after the game object tree. Their owners no longer update them
+		//
+		template<typename T>
+		struct UsesComponentPool : std::false_type {};
+
+		// Pools are updated phase by phase, every phase finishes before the next one starts
+		enum class UpdatePhase
+		{
+			Input,
+			_begin = Input,
+			Simulation,
+			Animation,
+			RenderSubmit,
+			_end
+		};
+
+		//
+		// Scheduling of a pooled type, specialise it next to UsesComponentPool. A parallel type has its
+		// slabs updated by different threads at once: its update may only read other objects and
+		// write to itself or to the render queue
+		//
+		template<typename T>
+		struct ComponentUpdatePolicy
+		{
+			static constexpr UpdatePhase Phase = UpdatePhase::Simulation;
+			static constexpr bool IsParallel = false;
+		};
+
+		class ComponentPoolBase
+		{
+		public:
+			virtual ~ComponentPoolBase() = default;
+
+			virtual UpdatePhase getUpdatePhase() const = 0;
+			virtual bool isParallel() const = 0;
+
+			virtual void updateAll(float dt) = 0;
+			// Chunks are independent, any of them can run on any thread
+			virtual size_t getNumChunks() const = 0;
+			virtual void updateChunk(size_t chunk, float dt) = 0;
+			virtual size_t getNumComponents() const = 0;
+
+			static const std::vector<ComponentPoolBase*>& GetAllPools();
+
+		protected:
+			static void RegisterPool(ComponentPoolBase& pool);
+		};
+
+		template<typename T>
+		class ComponentPool final : public ComponentPoolBase
+		{
+		public:
+			static ComponentPool& Get()
+			{
+				static ComponentPool pool;
+				return pool;
+			}
+
+			ComponentPool(const ComponentPool&) = delete;
+			ComponentPool& operator=(const ComponentPool&) = delete;
+
+			template<typename... Args>
+			std::shared_ptr<T> create(Args&& ...args)
+			{
+				if (_freeSlots.empty())
+				{
+					addSlab();
+				}
+
+				Slot* slot = _freeSlots.back();
+				T* component = new (&slot->storage) T(std::forward<Args>(args)...);
+				_freeSlots.pop_back();
+
+				slot->isLive = true;
+				component->_setPooled();
+				_numComponents++;
+
+				return std::shared_ptr<T>(component, [](T* pooled) { Get().destroy(pooled); });
+			}
+
+			UpdatePhase getUpdatePhase() const override
+			{
+				return ComponentUpdatePolicy<T>::Phase;
+			}
+
+			bool isParallel() const override
+			{
+				return ComponentUpdatePolicy<T>::IsParallel;
+			}
+
+			void updateAll(float dt) override
+			{
+				for (size_t chunk = 0; chunk < _slabs.size(); ++chunk)
+				{
+					updateChunk(chunk, dt);
+				}
+			}
+
+			// One chunk per slab
+			size_t getNumChunks() const override
+			{
+				return _slabs.size();
+			}
+
+			void updateChunk(size_t chunk, float dt) override
+			{
+				// Slots are visited in memory order. The qualified call skips the virtual dispatch,
+				// every slot holds exactly a T
+				Slot* slab = _slabs[chunk].get();
+				for (size_t i = 0; i < SlabSize; ++i)
+				{
+					Slot& slot = slab[i];
+					if (!slot.isLive)
+					{
+						continue;
+					}
+
+					T* component = reinterpret_cast<T*>(&slot.storage);
+					if (component->hasOwner())
+					{
+						component->T::update(dt);
+					}
+				}
+			}
+
+			size_t getNumComponents() const override
+			{
+				return _numComponents;
+			}
+
+		private:
+			static const size_t SlabSize = 256;
+
+			struct Slot
+			{
+				typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+				bool isLive = false;
+			};
+
+			ComponentPool()
+			{
+				RegisterPool(*this);
+			}
+
+			void addSlab()
+			{
+				_slabs.emplace_back(new Slot[SlabSize]);
+
+				// Reversed so slots are handed out in address order
+				Slot* slab = _slabs.back().get();
+				for (size_t i = SlabSize; i > 0; --i)
+				{
+					_freeSlots.push_back(&slab[i - 1]);
+				}
+			}
+
+			void destroy(T* component)
+			{
+				// The storage is the first member, so the component address is the slot address
+				Slot* slot = reinterpret_cast<Slot*>(component);
+				assert(slot->isLive);
+
+				component->~T();
+				slot->isLive = false;
+				_freeSlots.push_back(slot);
+				_numComponents--;
+			}
+
+			std::vector<std::unique_ptr<Slot[]>> _slabs;
+			std::vector<Slot*> _freeSlots;
+			size_t _numComponents = 0;
+		};
+	}
+}
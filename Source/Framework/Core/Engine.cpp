@@ -7,11 +7,33 @@
 #include "Engine.hpp"
 
 #include "GameObject.hpp"
+#include "ComponentPool.hpp"
+#include "TransformHierarchy.hpp"
+#include "StructuralChangeBuffer.hpp"
+#include "AnimationSystem.hpp"
+#include "Framework/Utils/JobSystem.hpp"
+#include "Framework/Utils/Random.hpp"
+#include "Framework/Utils/EnumIterator.hpp"
 
 #include "Engine/SDLEngine.hpp"
 
 using namespace Framework::Core;
 
+namespace
+{
+	thread_local size_t CurrentSubmitStream = Engine::MainSubmitStream;
+}
+
+Engine::Engine()
+{
+	// Empty on purpose
+}
+
+Engine::~Engine()
+{
+	// Empty on purpose, JobSystem is only complete here
+}
+
 void Engine::Settings::validate() const
 {
 	// Check that the assets path has a trailing '/'
@@ -24,14 +46,107 @@ void Engine::Settings::validate() const
 void Engine::callInit(Framework::Types::GameObject::PtrType gameObject)
 {
 	gameObject->internalInit();
+
+	StructuralChangeBuffer::Get().apply();
 }
 
 void Engine::callStart(Framework::Types::GameObject::PtrType gameObject)
 {
 	gameObject->internalStart();
+
+	StructuralChangeBuffer::Get().apply();
 }
 
 void Engine::callUpdate(Framework::Types::GameObject::PtrType gameObject, float dt)
 {
 	gameObject->internalUpdate(dt);
+
+	// Sync point, whatever was added or removed during the walk lands before the transform pass
+	StructuralChangeBuffer::Get().apply();
+
+	// Every animation of the frame in one batch. Nothing is being walked, so completion callbacks
+	// change the tree right away
+	AnimationSystem::Get().update(dt);
+
+	// One pass over the whole hierarchy, everything after this reads cached world transforms
+	TransformHierarchy::Get().updateWorldTransforms();
+
+	// Pooled components run after the whole tree, so they see the final positions of this frame
+	updatePools(dt);
+}
+
+void Engine::createJobSystem(uint32_t numWorkers)
+{
+	if (numWorkers > 0)
+	{
+		_jobSystem = std::make_unique<Utils::JobSystem>(numWorkers);
+	}
+}
+
+void Engine::seedRandom(uint64_t seed)
+{
+	// Called on the main thread, which is the one the game logic draws from
+	_randomSeed = Utils::Random::SetSeed(seed);
+}
+
+uint64_t Engine::getRandomSeed() const
+{
+	return _randomSeed;
+}
+
+size_t Engine::GetCurrentSubmitStream()
+{
+	return CurrentSubmitStream;
+}
+
+void Engine::updatePools(float dt)
+{
+	const std::vector<ComponentPoolBase*>& pools = ComponentPoolBase::GetAllPools();
+
+	for (EnumBEIterator<UpdatePhase> phase; phase; ++phase)
+	{
+		// Serial pools run first, on this thread and in registration order
+		_parallelPoolChunks.clear();
+		for (ComponentPoolBase* pool : pools)
+		{
+			if (pool->getUpdatePhase() != *phase)
+			{
+				continue;
+			}
+
+			if (pool->isParallel() && _jobSystem)
+			{
+				for (size_t chunk = 0; chunk < pool->getNumChunks(); ++chunk)
+				{
+					_parallelPoolChunks.push_back({ pool, chunk });
+				}
+			}
+			else
+			{
+				pool->updateAll(dt);
+			}
+		}
+
+		if (_parallelPoolChunks.empty())
+		{
+			continue;
+		}
+
+		// A world getter resolves dirty nodes in place, so whatever the serial pools moved is
+		// resolved here before the chunks read it from several threads
+		TransformHierarchy::Get().updateWorldTransforms();
+
+		// Chunk i submits to stream i, whichever thread picks it up
+		beginParallelSubmit(_parallelPoolChunks.size());
+		_jobSystem->parallelFor(_parallelPoolChunks.size(), 1, [this, dt](size_t chunk, size_t /*begin*/, size_t /*end*/)
+		{
+			CurrentSubmitStream = chunk;
+
+			const PoolChunk& poolChunk = _parallelPoolChunks[chunk];
+			poolChunk.pool->updateChunk(poolChunk.chunk, dt);
+
+			CurrentSubmitStream = MainSubmitStream;
+		});
+		endParallelSubmit();
+	}
 }
\ No newline at end of file
@@ -7,9 +7,24 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <memory>
 
 #include "Types.hpp"
 
+// Forward declarations
+namespace Framework
+{
+	namespace Core
+	{
+		class ComponentPoolBase;
+	}
+	namespace Utils
+	{
+		class JobSystem;
+	}
+}
+
 namespace Framework
 {
 	namespace Core
@@ -21,18 +36,68 @@ namespace Framework
 			using Size = Framework::Types::Size;
 			using Size2D = Framework::Types::Size2D;
 			using TextureId = Framework::Types::TextureId;
+			using FontId = Framework::Types::FontId;
+			using TextLayoutId = Framework::Types::TextLayoutId;
 			using Color3D = Framework::Types::Color3D;
 
+			enum class RendererType
+			{
+				FixedFunction,	// Legacy matrix stack and client arrays, runs on any compatibility context
+				Instanced,		// GL 3.3 core profile, one instance record per sprite and a shader-side transform
+			};
+
 			struct Settings
 			{
 				Size windowSize;
 				std::string assetsDirectoryPath = std::string("assets/");
 				std::string fontFileName = "berlin_sans_demi_72_0.png";
+				// Optional BMFont descriptor for the default font, the built-in metrics for fontFileName are used when empty
+				std::string fontDescriptorFileName;
+				// Images are decoded on this many threads, zero decodes them on the main thread
+				uint32_t numTextureLoaderThreads = 2;
+				// Main thread time per frame spent uploading decoded images, at least one is uploaded every frame
+				float textureUploadBudgetSeconds = 0.002f;
+				RendererType renderer = RendererType::FixedFunction;
+				// Parallel component pools are updated on this many threads on top of the main one, zero
+				// updates everything on the main thread
+				uint32_t numUpdateThreads = 2;
+				// Seed of Utils::Random, zero picks one at random. Runs with the same seed and input replay exactly
+				uint64_t randomSeed = 0;
 
 				void validate() const;
 			};
 
-			virtual ~Engine() = default;
+			struct TextureCacheStats
+			{
+				uint32_t hits = 0;
+				uint32_t misses = 0;
+				uint32_t uploads = 0;
+				uint32_t releases = 0;
+				uint32_t purged = 0;
+				uint32_t residentTextures = 0;
+			};
+
+			struct TextureInfo
+			{
+				uint32_t glTextureId = 0;	// Atlas page the texture lives in
+				Size size;
+				uint32_t pixelFormat = 0;	// SDL_PIXELFORMAT_* of the source image, pages store RGBA8
+				size_t cpuBytes = 0;		// Zero unless a CPU copy was requested
+				size_t gpuBytes = 0;		// Atlas area taken, padding included
+			};
+
+			struct TextureMemoryStats
+			{
+				size_t cpuBytes = 0;
+				size_t gpuBytes = 0;		// Whole atlas pages, free space included
+			};
+
+			static const FontId DefaultFontId = 0;
+			static const TextLayoutId InvalidTextLayoutId = static_cast<TextLayoutId>(-1);
+			static const size_t MainSubmitStream = static_cast<size_t>(-1);
+
+			Engine();
+			virtual ~Engine();
 
 			virtual void start(Types::GameObject::PtrType updater) = 0;
 			virtual void stop() = 0;
@@ -42,20 +107,70 @@ namespace Framework
 			virtual Size getScreenSize() const = 0;
 			virtual float getElapsedTime() const = 0;
 
-			virtual TextureId registerTexture(const std::string& assetPath) = 0;
+			// The one actually in use, also when it was picked at random
+			uint64_t getRandomSeed() const;
+
+			// Textures are reference counted: every registerTexture must be paired with a releaseTexture.
+			// Unreferenced textures stay cached until purgeUnusedTextures is called
+			// The decoded image is freed once uploaded unless keepCpuCopy is set. Loading may complete
+			// asynchronously: the size is known straight away but the sprite is not drawn until it is resident
+			virtual TextureId registerTexture(const std::string& assetPath, bool keepCpuCopy = false) = 0;
+			virtual bool isTextureResident(TextureId textureId) const = 0;
+			// Registers the assets and blocks until they are resident, the ids are released as usual
+			virtual std::vector<TextureId> preloadTextures(const std::vector<std::string>& assetPaths) = 0;
+			virtual void waitForPendingTextures() = 0;
+			virtual void releaseTexture(TextureId textureId) = 0;
+			virtual void purgeUnusedTextures() = 0;
+			virtual TextureCacheStats getTextureCacheStats() const = 0;
+			virtual TextureInfo getTextureInfo(TextureId textureId) const = 0;
+			virtual TextureMemoryStats getTextureMemoryStats() const = 0;
 			virtual Size getTextureSize(TextureId spriteId) const = 0;
-			virtual Size2D getTextSize(const std::string& text, float scale) const = 0;
-			virtual float getCharacterAdvance(const char character, float scale = 1.0f) const = 0;
+			virtual FontId registerFont(const std::string& descriptorAssetPath) = 0;
+			virtual Size2D getTextSize(const std::string& text, float scale, FontId fontId = DefaultFontId) const = 0;
+			virtual float getCharacterAdvance(const char character, float scale = 1.0f, FontId fontId = DefaultFontId) const = 0;
 
 			virtual void render(TextureId spriteId, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) = 0;
-			virtual void renderText(const std::string& text, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) = 0;
-			virtual void renderText(const std::string& text, const Point2D& position, const std::vector<float>& yPositions, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) = 0;
+			virtual void renderText(const std::string& text, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f, FontId fontId = DefaultFontId) = 0;
+			virtual void renderText(const std::string& text, const Point2D& position, const std::vector<float>& yPositions, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f, FontId fontId = DefaultFontId) = 0;
+
+			// Text laid out once and reused every frame until its content changes. Layouts are
+			// built at unit scale, so scaling them while rendering does not rebuild anything
+			virtual TextLayoutId createTextLayout(const std::string& text, FontId fontId = DefaultFontId) = 0;
+			virtual void updateTextLayout(TextLayoutId layoutId, const std::string& text) = 0;
+			virtual void releaseTextLayout(TextLayoutId layoutId) = 0;
+			virtual Size2D getTextLayoutSize(TextLayoutId layoutId, float scale = 1.0f) const = 0;
+			virtual void renderTextLayout(TextLayoutId layoutId, const Point2D& position, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) = 0;
+			virtual void renderTextLayout(TextLayoutId layoutId, const Point2D& position, const std::vector<float>& yOffsets, int zIndex = 0, const Color3D& color = Color3D(1.0f, 1.0f, 1.0f), float rotation = 0.0f, float scale = 1.0f, float opacity = 1.0f) = 0;
+
+			// Render calls between these two may come from several threads. Each parallel job submits to
+			// its own stream and the streams are appended to the frame in index order on end, so the draw
+			// order does not depend on how the jobs were scheduled
+			virtual void beginParallelSubmit(size_t numStreams) = 0;
+			virtual void endParallelSubmit() = 0;
 
 		protected:
 #pragma region - Convenience methods for derived class
 			void callInit(Framework::Types::GameObject::PtrType gameObject);
 			void callStart(Framework::Types::GameObject::PtrType gameObject);
 			void callUpdate(Framework::Types::GameObject::PtrType gameObject, float dt);
+
+			void createJobSystem(uint32_t numWorkers);
+			void seedRandom(uint64_t seed);
+			// Stream of the calling thread, MainSubmitStream outside parallel jobs
+			static size_t GetCurrentSubmitStream();
+
+		private:
+			struct PoolChunk
+			{
+				ComponentPoolBase* pool;
+				size_t chunk;
+			};
+
+			void updatePools(float dt);
+
+			std::unique_ptr<Utils::JobSystem> _jobSystem;
+			std::vector<PoolChunk> _parallelPoolChunks;
+			uint64_t _randomSeed = 0;
 		};
 	}
 }
\ No newline at end of file
@@ -27,4 +27,9 @@ Framework::Types::Engine::PtrType EngineOwner::getEngine()
 {
     assert(_engine);
     return _engine;
+}
+
+bool EngineOwner::hasEngine() const
+{
+    return _engine != nullptr;
 }
\ No newline at end of file
@@ -23,6 +23,7 @@ namespace Framework
 
 			const Types::Engine::PtrType getEngine() const;
 			Types::Engine::PtrType getEngine();
+			bool hasEngine() const;
 
 		private:
 			Types::Engine::PtrType _engine;
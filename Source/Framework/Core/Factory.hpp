@@ -8,6 +8,7 @@
 
 #include "EngineOwner.hpp"
 #include "ILifeCycle.hpp"
+#include "ComponentPool.hpp"
 
 namespace Framework
 {
@@ -23,7 +24,15 @@ namespace Framework
 			std::shared_ptr<T> CreateComponent(Args&& ...args)
 			{
 				static_assert(std::is_base_of<GameComponent, T>::value, "Component must inherit from GameComponent");
-				auto component = std::make_shared<T>(std::forward<Args>(args)...);
+				std::shared_ptr<T> component;
+				if constexpr (UsesComponentPool<T>::value)
+				{
+					component = ComponentPool<T>::Get().create(std::forward<Args>(args)...);
+				}
+				else
+				{
+					component = std::make_shared<T>(std::forward<Args>(args)...);
+				}
 				component->setEngine(getEngine());
 				component->internalInit();
 				return std::move(component);
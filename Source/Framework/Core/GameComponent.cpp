@@ -16,15 +16,25 @@ GameComponent::GameComponent()
 	// Empty on purpose
 }
 
-const std::string& GameComponent::getComponentId() const
+const Framework::Types::ComponentId& GameComponent::getComponentId() const
 {
 	return _componentId;
 }
 
+bool GameComponent::isPooled() const
+{
+	return _isPooled;
+}
+
+void GameComponent::_setPooled()
+{
+	_isPooled = true;
+}
+
 void GameComponent::internalInit()
 {
 	_componentId = GetComponentIdFromThis(*this);
-	generateInstanceId(_componentId);
+	generateInstanceId();
 
 	init();
 }
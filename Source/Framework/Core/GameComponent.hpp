@@ -32,6 +32,9 @@ namespace Framework
 			const ComponentId& getComponentId() const;
 			using Instanceable::getInstanceId;
 
+			// Pooled components are updated by their pool, see ComponentPool.hpp
+			bool isPooled() const;
+
 			void init() override;
 			void start() override;
 			void update(float dt) override;
@@ -39,14 +42,19 @@ namespace Framework
 		protected:
 			friend class GameComponentContainer;
 			friend class Factory;
+			template<typename T>
+			friend class ComponentPool;
 			void internalInit() override;
 			void internalStart() override;
 			void internalUpdate(float dt) override;
 
 			GameComponent();
 
+			void _setPooled();
+
 		private:
 			ComponentId _componentId;
+			bool _isPooled = false;
 		};
 
 	}
@@ -6,35 +6,66 @@
 
 #include "GameComponentContainer.hpp"
 
+#include <algorithm>
+
+#include "GameObject.hpp"
+#include "StructuralChangeBuffer.hpp"
+
 using namespace Framework;
 using namespace Framework::Core;
 using namespace Framework::Types;
 
-void GameComponentContainer::addComponent(Types::GameComponent::PtrType component)
+namespace
 {
-	const ComponentId& componentId = component->getComponentId();
-	const InstanceId& instanceId = component->getInstanceId();
+	bool IsOwnedBy(const GameObjectOwner& component, const GameComponentContainer& container)
+	{
+		// Another game object may have adopted it in the meantime
+		return component.hasOwner() && static_cast<const GameComponentContainer*>(&component.getOwner()) == &container;
+	}
+}
 
-	_notStartedComponents.push(component);
+GameComponentContainer::~GameComponentContainer()
+{
+	if (_numQueuedChanges > 0)
+	{
+		StructuralChangeBuffer::Get().cancel(*this);
+	}
+}
 
+void GameComponentContainer::addComponent(Types::GameComponent::PtrType component)
+{
 	// Dependency injection
-	Types::GameObject::PtrType gameObjectPtr = shared_from_this();
-	component->_setOwner(gameObjectPtr);
-
-	// Map by Instance Id
-	auto insertionIter = _componentsMapByInstanceId.insert(std::pair<InstanceId, Types::GameComponent::PtrType>(instanceId, std::move(component)));
-	assert(insertionIter.second);
+	component->_setOwner(shared_from_this().get());
 
-	// Map by Component Id
-	auto componentsMapIter = _componentsMapByComponentId.find(componentId);
-	if (componentsMapIter != _componentsMapByComponentId.end())
+	if (isWalkingComponents())
 	{
-		componentsMapIter->second.emplace(instanceId);
+		StructuralChangeBuffer::Get().queueAddComponent(*this, std::move(component));
+		return;
 	}
-	else
+
+	applyAddComponent(std::move(component));
+}
+
+void GameComponentContainer::applyAddComponent(Types::GameComponent::PtrType component)
+{
+	const ComponentId componentId = component->getComponentId();
+	const InstanceId instanceId = component->getInstanceId();
+
+	_notStartedComponents.push(component);
+
+	// Map by Component Id
+	if (componentId >= _componentsMapByComponentId.size())
 	{
-		_componentsMapByComponentId.emplace(componentId, std::set<InstanceId>{instanceId});
+		_componentsMapByComponentId.resize(componentId + 1);
 	}
+
+	ComponentTypeEntry& typeEntry = _componentsMapByComponentId[componentId];
+	typeEntry.instanceIds.push_back(instanceId);
+	typeEntry.components.push_back(component);
+
+	// Map by Instance Id
+	[[maybe_unused]] const bool isInserted = _componentsMapByInstanceId.insert(instanceId, std::move(component));
+	assert(isInserted);
 }
 
 bool GameComponentContainer::removeComponent(const Core::GameComponent& component)
@@ -44,23 +75,56 @@ bool GameComponentContainer::removeComponent(const Core::GameComponent& componen
 }
 
 bool GameComponentContainer::removeComponent(const InstanceId& instanceId)
+{
+	if (isWalkingComponents())
+	{
+		const Types::GameComponent::PtrType* componentPtr = _componentsMapByInstanceId.find(instanceId);
+		if (componentPtr == nullptr)
+		{
+			return false;
+		}
+
+		(*componentPtr)->_setPendingRemoval(true);
+		StructuralChangeBuffer::Get().queueRemoveComponent(*this, instanceId);
+		return true;
+	}
+
+	return applyRemoveComponent(instanceId);
+}
+
+bool GameComponentContainer::applyRemoveComponent(const InstanceId& instanceId)
 {
 	bool retValue = true;
 
-	auto findIter = _componentsMapByInstanceId.find(instanceId);
-	if (findIter == _componentsMapByInstanceId.end())
+	const Types::GameComponent::PtrType* componentPtr = _componentsMapByInstanceId.find(instanceId);
+	if (componentPtr == nullptr)
 	{
 		return false;
 	}
 
-	const GameComponent& component = *(findIter->second);
-	const ComponentId& componentId = component.getComponentId();
+	(*componentPtr)->_setPendingRemoval(false);
+
+	// Copied, the component may die with the erase below
+	const ComponentId componentId = (*componentPtr)->getComponentId();
+
+	// Someone else may still hold it, it must not point back to us and a pooled one must stop updating
+	if (IsOwnedBy(**componentPtr, *this))
+	{
+		(*componentPtr)->_setOwner(nullptr);
+	}
 
 	// Map by Component Id
-	auto componentsMapIter = _componentsMapByComponentId.find(componentId);
-	if (componentsMapIter != _componentsMapByComponentId.end())
+	ComponentTypeEntry& typeEntry = _componentsMapByComponentId[componentId];
+
+	auto idIter = std::find(typeEntry.instanceIds.begin(), typeEntry.instanceIds.end(), instanceId);
+	if (idIter != typeEntry.instanceIds.end())
 	{
-		componentsMapIter->second.erase(instanceId);
+		const size_t position = static_cast<size_t>(idIter - typeEntry.instanceIds.begin());
+
+		typeEntry.instanceIds[position] = typeEntry.instanceIds.back();
+		typeEntry.instanceIds.pop_back();
+		typeEntry.components[position] = std::move(typeEntry.components.back());
+		typeEntry.components.pop_back();
 	}
 	else
 	{
@@ -68,7 +132,7 @@ bool GameComponentContainer::removeComponent(const InstanceId& instanceId)
 	}
 
 	// Map by Instance Id
-	_componentsMapByInstanceId.erase(findIter);
+	_componentsMapByInstanceId.erase(instanceId);
 
 	return retValue;
 }
@@ -81,46 +145,77 @@ bool GameComponentContainer::hasComponent(const Core::GameComponent& component)
 
 bool GameComponentContainer::hasComponents(const ComponentId& componentId) const
 {
-	auto componentsMapIter = _componentsMapByComponentId.find(componentId);
-	return componentsMapIter != _componentsMapByComponentId.end();
+	return componentId < _componentsMapByComponentId.size() && !_componentsMapByComponentId[componentId].instanceIds.empty();
 }
 
 bool GameComponentContainer::hasComponent(const InstanceId& instanceId) const
 {
-	auto instancesMapIter = _componentsMapByInstanceId.find(instanceId);
-	return instancesMapIter != _componentsMapByInstanceId.end();
+	return _componentsMapByInstanceId.contains(instanceId);
 }
 
-const std::set<InstanceId>& GameComponentContainer::getComponentsIds(const ComponentId& componentId) const
+const std::vector<InstanceId>& GameComponentContainer::getComponentsIds(const ComponentId& componentId) const
 {
-	auto componentsMapIter = _componentsMapByComponentId.find(componentId);
-	assert(componentsMapIter != _componentsMapByComponentId.end());
+	return getComponentTypeEntry(componentId).instanceIds;
+}
 
-	return componentsMapIter->second;
+const GameComponentContainer::ComponentTypeEntry& GameComponentContainer::getComponentTypeEntry(const ComponentId& componentId) const
+{
+	assert(componentId < _componentsMapByComponentId.size());
+	return _componentsMapByComponentId[componentId];
+}
+
+void GameComponentContainer::releaseComponents()
+{
+	for (size_t i = 0; i < _componentsMapByInstanceId.size(); ++i)
+	{
+		GameComponent& component = *_componentsMapByInstanceId.valueAt(i);
+		if (IsOwnedBy(component, *this))
+		{
+			component._setOwner(nullptr);
+		}
+	}
 }
 
 void GameComponentContainer::internalInit()
 {
-	for (auto& componentPair : _componentsMapByInstanceId)
+	++_walkDepth;
+	for (size_t i = 0; i < _componentsMapByInstanceId.size(); ++i)
 	{
-		componentPair.second->init();
+		GameComponent& component = *_componentsMapByInstanceId.valueAt(i);
+		if (!component.isPendingRemoval())
+		{
+			component.init();
+		}
 	}
+	--_walkDepth;
 }
 
 void GameComponentContainer::internalStart()
 {
-	for (auto& componentPair : _componentsMapByInstanceId)
+	++_walkDepth;
+	for (size_t i = 0; i < _componentsMapByInstanceId.size(); ++i)
 	{
-		componentPair.second->start();
+		GameComponent& component = *_componentsMapByInstanceId.valueAt(i);
+		if (!component.isPendingRemoval())
+		{
+			component.start();
+		}
 	}
+	--_walkDepth;
 }
 
 void GameComponentContainer::internalUpdate(float dt)
 {
-	for (auto& componentPair : _componentsMapByInstanceId)
+	++_walkDepth;
+	for (size_t i = 0; i < _componentsMapByInstanceId.size(); ++i)
 	{
-		componentPair.second->update(dt);
+		GameComponent& component = *_componentsMapByInstanceId.valueAt(i);
+		if (!component.isPooled() && !component.isPendingRemoval())
+		{
+			component.update(dt);
+		}
 	}
+	--_walkDepth;
 }
 
 void GameComponentContainer::updateNotStarted()
@@ -140,4 +235,9 @@ void GameComponentContainer::updateNotStarted()
 			gameComponent->internalStart();
 		}
 	}
+}
+
+bool GameComponentContainer::isWalkingComponents() const
+{
+	return _walkDepth > 0;
 }
\ No newline at end of file
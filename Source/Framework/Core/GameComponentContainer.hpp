@@ -6,13 +6,14 @@
 
 #pragma once
 
-#include <set>
+#include <vector>
 #include <queue>
 
 #include "Types.hpp"
 
 #include "GameComponent.hpp"
 #include "Framework/Utils/Utils.hpp"
+#include "Framework/Utils/DenseHandleMap.hpp"
 
 namespace Framework
 {
@@ -31,8 +32,11 @@ namespace Framework
 		{
 		public:
 			GameComponentContainer() = default;
-			virtual ~GameComponentContainer() = default;
+			virtual ~GameComponentContainer();
 
+			// While our components are being walked, adds and removes wait for the next sync point,
+			// see StructuralChangeBuffer. The owner is set right away, a removed component is no
+			// longer updated in the meantime and removing reports whether it was found
 			virtual void addComponent(Types::GameComponent::PtrType component);
 
 			bool removeComponent(const GameComponent& component);
@@ -46,9 +50,9 @@ namespace Framework
 			std::shared_ptr<T> getComponent(const InstanceId& instanceId);
 			template<typename T>
 			std::shared_ptr<const T> getComponent(const InstanceId& instanceId) const;
-			const std::set<InstanceId>& getComponentsIds(const ComponentId& componentId) const;
+			const std::vector<InstanceId>& getComponentsIds(const ComponentId& componentId) const;
 			template<typename T>
-			const std::set<InstanceId>& getComponentsIds() const;
+			const std::vector<InstanceId>& getComponentsIds() const;
 
 			// Works if only there is 1 component of the given type
 			template<typename T>
@@ -65,12 +69,31 @@ namespace Framework
 			void internalStart() override;
 			void internalUpdate(float dt) override;
 
+			// Detaches every component that still points back to us
+			void releaseComponents();
+
 		private:
+			friend class StructuralChangeBuffer;
+
+			// Every component in here has exactly this type, so typed accessors need no dynamic cast
+			struct ComponentTypeEntry
+			{
+				std::vector<InstanceId> instanceIds;
+				std::vector<Types::GameComponent::PtrType> components;
+			};
+
+			const ComponentTypeEntry& getComponentTypeEntry(const ComponentId& componentId) const;
 			void updateNotStarted();
+			bool isWalkingComponents() const;
+			void applyAddComponent(Types::GameComponent::PtrType component);
+			bool applyRemoveComponent(const InstanceId& instanceId);
 
 			std::queue<Types::GameComponent::WeakPtrType> _notStartedComponents;
-			std::unordered_map<InstanceId, Types::GameComponent::PtrType> _componentsMapByInstanceId;
-			std::unordered_map<ComponentId, std::set<InstanceId>> _componentsMapByComponentId;
+			Utils::DenseHandleMap<Types::GameComponent::PtrType> _componentsMapByInstanceId;
+			std::vector<ComponentTypeEntry> _componentsMapByComponentId;	// Indexed by ComponentId
+
+			uint32_t _walkDepth = 0;
+			uint32_t _numQueuedChanges = 0;
 		};
 
 #include "GameComponentContainer.inl.hpp"
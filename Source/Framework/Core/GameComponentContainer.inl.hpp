@@ -7,44 +7,41 @@
 template<typename T>
 std::shared_ptr<T> GameComponentContainer::getComponent(const InstanceId& instanceId)
 {
-	auto instancesMapIter = _componentsMapByInstanceId.find(instanceId);
-	assert(instancesMapIter != _componentsMapByInstanceId.end());
-	return std::dynamic_pointer_cast<T>(instancesMapIter->second);
+	auto componentPtr = _componentsMapByInstanceId.find(instanceId);
+	assert(componentPtr != nullptr);
+	assert(std::dynamic_pointer_cast<T>(*componentPtr));
+	return std::static_pointer_cast<T>(*componentPtr);
 }
 
 template<typename T>
 std::shared_ptr<const T> GameComponentContainer::getComponent(const InstanceId& instanceId) const
 {
-	auto instancesMapIter = _componentsMapByInstanceId.find(instanceId);
-	assert(instancesMapIter != _componentsMapByInstanceId.end());
-	return std::dynamic_pointer_cast<const T>(instancesMapIter->second);
+	auto componentPtr = _componentsMapByInstanceId.find(instanceId);
+	assert(componentPtr != nullptr);
+	assert(std::dynamic_pointer_cast<const T>(*componentPtr));
+	return std::static_pointer_cast<const T>(*componentPtr);
 }
 
 template<typename T>
 std::shared_ptr<T> GameComponentContainer::getComponent()
 {
-	const std::string& componentId = Framework::Utils::GetComponentIdFromClass<T>();
-	const std::set<InstanceId>& instancesIds = getComponentsIds(componentId);
-	assert(instancesIds.size() == 1);
+	const ComponentTypeEntry& typeEntry = getComponentTypeEntry(Framework::Utils::GetComponentIdFromClass<T>());
+	assert(typeEntry.components.size() == 1);
 
-	const InstanceId& instanceId = *instancesIds.begin();
-	return getComponent<T>(instanceId);
+	return std::static_pointer_cast<T>(typeEntry.components.front());
 }
 
 template<typename T>
 std::shared_ptr<const T> GameComponentContainer::getComponent() const
 {
-	const std::string& componentId = Framework::Utils::GetComponentIdFromClass<T>();
-	const std::set<InstanceId>& instancesIds = getComponentsIds(componentId);
-	assert(instancesIds.size() == 1);
+	const ComponentTypeEntry& typeEntry = getComponentTypeEntry(Framework::Utils::GetComponentIdFromClass<T>());
+	assert(typeEntry.components.size() == 1);
 
-	const InstanceId& instanceId = *instancesIds.begin();
-	return getComponent<T>(instanceId);
+	return std::static_pointer_cast<const T>(typeEntry.components.front());
 }
 
 template<typename T>
-const std::set<InstanceId>& GameComponentContainer::getComponentsIds() const
+const std::vector<InstanceId>& GameComponentContainer::getComponentsIds() const
 {
-	const std::string& componentId = Framework::Utils::GetComponentIdFromClass<T>();
-	return getComponentsIds(componentId);
+	return getComponentsIds(Framework::Utils::GetComponentIdFromClass<T>());
 }
\ No newline at end of file
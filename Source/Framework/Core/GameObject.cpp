@@ -9,57 +9,81 @@
 #include "GameObject.hpp"
 
 #include "Engine.hpp"
+#include "AnimationSystem.hpp"
 
 using namespace Framework;
 using namespace Framework::Core;
 using namespace Framework::Types;
 
+Core::GameObject::GameObject()
+	: _transformNode(TransformHierarchy::Get().createNode())
+{
+	// Empty on purpose
+}
+
+Core::GameObject::~GameObject()
+{
+	// Children and components shared elsewhere outlive us, they must not keep pointing back here
+	releaseGameObjects();
+	releaseComponents();
+
+	AnimationSystem::Get().stopAll(*this);
+	TransformHierarchy::Get().destroyNode(_transformNode);
+}
+
 void Core::GameObject::setWorldPosition(const Point2D& newPosition)
 {
-	_worldPosition = newPosition;
-	updateLocalPosition(_worldPosition);
+	TransformHierarchy::Get().setWorldPosition(_transformNode, newPosition);
 }
 
-const Point2D& Core::GameObject::getWorldPosition() const
+Point2D Core::GameObject::getWorldPosition() const
 {
-	return _worldPosition;
+	return TransformHierarchy::Get().getWorldPosition(_transformNode);
 }
 
 void Core::GameObject::setLocalPosition(const Point2D& newPosition)
 {
-	_localPosition = newPosition;
-	updateWorldPosition(_localPosition);
+	TransformHierarchy::Get().setLocalPosition(_transformNode, newPosition);
 }
 
-const Point2D& Core::GameObject::getLocalPosition() const
+Point2D Core::GameObject::getLocalPosition() const
 {
-	return _localPosition;
+	return TransformHierarchy::Get().getLocalPosition(_transformNode);
 }
 
-void Core::GameObject::updateWorldPosition(const Point2D& newPosition)
+void Core::GameObject::setLocalRotation(float radians)
 {
-	if (!hasOwner())
-	{
-		_worldPosition = newPosition;
-	}
-	else
-	{
-		const GameObject& owner = getOwner();
-		_worldPosition = owner.getWorldPosition() + newPosition;
-	}
+	TransformHierarchy::Get().setLocalRotation(_transformNode, radians);
 }
 
-void Core::GameObject::updateLocalPosition(const Point2D& newPosition)
+float Core::GameObject::getLocalRotation() const
 {
-	if (!hasOwner())
-	{
-		_localPosition = newPosition;
-	}
-	else
-	{
-		const GameObject& owner = getOwner();
-		_localPosition = newPosition - owner.getWorldPosition();
-	}
+	return TransformHierarchy::Get().getLocalRotation(_transformNode);
+}
+
+float Core::GameObject::getWorldRotation() const
+{
+	return TransformHierarchy::Get().getWorldRotation(_transformNode);
+}
+
+void Core::GameObject::setLocalScale(float scale)
+{
+	TransformHierarchy::Get().setLocalScale(_transformNode, scale);
+}
+
+float Core::GameObject::getLocalScale() const
+{
+	return TransformHierarchy::Get().getLocalScale(_transformNode);
+}
+
+float Core::GameObject::getWorldScale() const
+{
+	return TransformHierarchy::Get().getWorldScale(_transformNode);
+}
+
+Point2D Core::GameObject::localToWorld(const Point2D& localPoint) const
+{
+	return TransformHierarchy::Get().localToWorld(_transformNode, localPoint);
 }
 
 Point2D Core::GameObject::getAnchorPointLocalPosition() const
@@ -68,12 +92,28 @@ Point2D Core::GameObject::getAnchorPointLocalPosition() const
 	return size * getAnchorPoint();
 }
 
-void Core::GameObject::_setOwner(Types::GameObject::WeakPtrType gameObject)
+void Core::GameObject::_setOwner(GameObject* gameObject)
 {
 	GameObjectOwner::_setOwner(gameObject);
 
-	// Local position takes precedence over world position
-	updateWorldPosition(_localPosition);
+	TransformHierarchy& transforms = TransformHierarchy::Get();
+	if (gameObject != nullptr)
+	{
+		// Local transform takes precedence over world transform
+		transforms.setParent(_transformNode, gameObject->_transformNode);
+	}
+	else
+	{
+		// A detached object keeps where it was
+		const Point2D worldPosition = transforms.getWorldPosition(_transformNode);
+		const float worldRotation = transforms.getWorldRotation(_transformNode);
+		const float worldScale = transforms.getWorldScale(_transformNode);
+
+		transforms.setParent(_transformNode, TransformHierarchy::InvalidNode);
+		transforms.setLocalPosition(_transformNode, worldPosition);
+		transforms.setLocalRotation(_transformNode, worldRotation);
+		transforms.setLocalScale(_transformNode, worldScale);
+	}
 }
 
 void Core::GameObject::setZIndex(int zIndex)
@@ -88,8 +128,7 @@ int Core::GameObject::getZIndex() const
 
 void Core::GameObject::internalInit()
 {
-	const std::string& classId = typeid(*this).name();
-	generateInstanceId(classId);
+	generateInstanceId();
 
 	GameObjectContainer::internalInit();
 	GameComponentContainer::internalInit();
@@ -110,14 +149,16 @@ void Core::GameObject::internalUpdate(float dt)
 	GameObjectContainer::internalUpdate(dt);
 	GameComponentContainer::internalUpdate(dt);
 
-	update(dt);
+	if (_isUpdateEnabled)
+	{
+		update(dt);
+	}
 }
 
 void Core::GameObject::addGameObject(Types::GameObject::PtrType gameObject)
 {
-	auto ptr = shared_from_this();
 	gameObject->setEngine(getEngine());
-	gameObject->_setOwner(ptr);
+	gameObject->_setOwner(this);
 
 	GameObjectContainer::addGameObject(std::move(gameObject));
 }
@@ -158,4 +199,13 @@ void Core::GameObject::start()
 void Core::GameObject::update(float /* dt */)
 {
 	// Empty on purpose, allow basic GameObjects to just work
-}
\ No newline at end of file
+}
+void Core::GameObject::setUpdateEnabled(bool enabled)
+{
+	_isUpdateEnabled = enabled;
+}
+
+bool Core::GameObject::isUpdateEnabled() const
+{
+	return _isUpdateEnabled;
+}
@@ -13,6 +13,7 @@
 #include "Factory.hpp"
 #include "EngineOwner.hpp"
 #include "AnchorPointUser.hpp"
+#include "TransformHierarchy.hpp"
 
 namespace Framework
 {
@@ -23,12 +24,22 @@ namespace Framework
 			public AnchorPointUser, public Factory, public GameObjectOwner
 		{
 		public:
-			GameObject() = default;
+			GameObject();
+			~GameObject() override;
 
+			// Children follow their owner. World values are resolved lazily, see TransformHierarchy
 			void setWorldPosition(const Point2D& newPosition);
-			const Point2D& getWorldPosition() const;
+			Point2D getWorldPosition() const;
 			void setLocalPosition(const Point2D& newPosition);
-			const Point2D& getLocalPosition() const;
+			Point2D getLocalPosition() const;
+			void setLocalRotation(float radians);
+			float getLocalRotation() const;
+			float getWorldRotation() const;
+			void setLocalScale(float scale);
+			float getLocalScale() const;
+			float getWorldScale() const;
+
+			Point2D localToWorld(const Point2D& localPoint) const;
 
 			Point2D getAnchorPointLocalPosition() const;
 
@@ -46,26 +57,28 @@ namespace Framework
 
 			bool isPointInside(const Point2D& point) const;
 
+			// Objects driven only by the AnimationSystem switch their own update() off while idle,
+			// their children and components are still updated
+			void setUpdateEnabled(bool enabled);
+			bool isUpdateEnabled() const;
+
 		protected:
 			friend class Framework::Core::Engine;
 			friend class Framework::Core::GameObjectContainer;
 			friend class Framework::Core::Factory;
+			friend class AnimationSystem;
 
 			void internalInit() override;
 			void internalStart() override;
 			void internalUpdate(float dt) override;
 
-			void _setOwner(Types::GameObject::WeakPtrType gameObject) override;
+			void _setOwner(GameObject* gameObject) override;
 
 		private:
-			void updateLocalPosition(const Point2D& newPosition);
-			void updateWorldPosition(const Point2D& newPosition);
-
-			Types::GameObject::WeakPtrType _parentObject;
-			Point2D _worldPosition;
-			Point2D _localPosition;
+			TransformHierarchy::NodeId _transformNode;
 			Size2D _size;
 			int _zIndex = 0;
+			bool _isUpdateEnabled = true;
 		};
 	}
 }
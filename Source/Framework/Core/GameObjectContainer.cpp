@@ -9,15 +9,38 @@
 #include "GameObjectContainer.hpp"
 
 #include "GameObject.hpp"
+#include "StructuralChangeBuffer.hpp"
 
 using namespace Framework;
 using namespace Framework::Core;
 using namespace Framework::Types;
 
+namespace
+{
+	bool IsOwnedBy(const GameObjectOwner& gameObject, const GameObjectContainer& container)
+	{
+		// Another container may have adopted it in the meantime
+		return gameObject.hasOwner() && static_cast<const GameObjectContainer*>(&gameObject.getOwner()) == &container;
+	}
+}
+
+GameObjectContainer::~GameObjectContainer()
+{
+	if (_numQueuedChanges > 0)
+	{
+		StructuralChangeBuffer::Get().cancel(*this);
+	}
+}
+
 void GameObjectContainer::addGameObject(Types::GameObject::PtrType gameObject)
 {
-	_notStartedObjects.push(gameObject);
-	doAddGameObject(std::move(gameObject));
+	if (isWalkingGameObjects())
+	{
+		StructuralChangeBuffer::Get().queueAddGameObject(*this, std::move(gameObject));
+		return;
+	}
+
+	applyAddGameObject(std::move(gameObject));
 }
 
 bool GameObjectContainer::hasGameObject(const Core::GameObject& gameObject) const
@@ -27,8 +50,7 @@ bool GameObjectContainer::hasGameObject(const Core::GameObject& gameObject) cons
 
 bool GameObjectContainer::hasGameObject(const InstanceId& instanceId) const
 {
-	auto goMapIter = _gameObjects.find(instanceId);
-	return goMapIter != _gameObjects.end();
+	return _gameObjects.contains(instanceId);
 }
 
 void GameObjectContainer::removeGameObject(const Core::GameObject& gameObject)
@@ -40,35 +62,104 @@ void GameObjectContainer::removeGameObject(const Core::GameObject& gameObject)
 
 void GameObjectContainer::removeGameObject(const InstanceId& instanceId)
 {
+	if (isWalkingGameObjects())
+	{
+		const Types::GameObject::PtrType* gameObjectPtr = _gameObjects.find(instanceId);
+		if (gameObjectPtr != nullptr)
+		{
+			(*gameObjectPtr)->_setPendingRemoval(true);
+		}
+
+		StructuralChangeBuffer::Get().queueRemoveGameObject(*this, instanceId);
+		return;
+	}
+
+	applyRemoveGameObject(instanceId);
+}
+
+void GameObjectContainer::applyAddGameObject(Types::GameObject::PtrType gameObject)
+{
+	_notStartedObjects.push(gameObject);
+
+	const InstanceId& instanceId = gameObject->getInstanceId();
+	_gameObjects.insert(instanceId, std::move(gameObject));
+}
+
+void GameObjectContainer::applyRemoveGameObject(const InstanceId& instanceId)
+{
+	const Types::GameObject::PtrType* gameObjectPtr = _gameObjects.find(instanceId);
+	if (gameObjectPtr == nullptr)
+	{
+		return;
+	}
+
+	(*gameObjectPtr)->_setPendingRemoval(false);
+
+	// Someone else may still hold it, it must not point back to us
+	if (IsOwnedBy(**gameObjectPtr, *this))
+	{
+		(*gameObjectPtr)->_setOwner(nullptr);
+	}
+
 	_gameObjects.erase(instanceId);
 }
 
+void GameObjectContainer::releaseGameObjects()
+{
+	for (size_t i = 0; i < _gameObjects.size(); ++i)
+	{
+		GameObject& gameObject = *_gameObjects.valueAt(i);
+		if (IsOwnedBy(gameObject, *this))
+		{
+			gameObject._setOwner(nullptr);
+		}
+	}
+}
+
 void GameObjectContainer::internalInit()
 {
-	for (auto& gameObject : _gameObjects)
+	++_walkDepth;
+	for (size_t i = 0; i < _gameObjects.size(); ++i)
 	{
-		gameObject.second->internalInit();
+		GameObject& gameObject = *_gameObjects.valueAt(i);
+		if (!gameObject.isPendingRemoval())
+		{
+			gameObject.internalInit();
+		}
 	}
+	--_walkDepth;
 }
 
 void GameObjectContainer::internalStart()
 {
 	updateNotStarted();
 
-	for (auto& gameObject : _gameObjects)
+	++_walkDepth;
+	for (size_t i = 0; i < _gameObjects.size(); ++i)
 	{
-		gameObject.second->internalStart();
+		GameObject& gameObject = *_gameObjects.valueAt(i);
+		if (!gameObject.isPendingRemoval())
+		{
+			gameObject.internalStart();
+		}
 	}
+	--_walkDepth;
 }
 
 void GameObjectContainer::internalUpdate(float dt)
 {
 	updateNotStarted();
 
-	for (auto& gameObject : _gameObjects)
+	++_walkDepth;
+	for (size_t i = 0; i < _gameObjects.size(); ++i)
 	{
-		gameObject.second->internalUpdate(dt);
+		GameObject& gameObject = *_gameObjects.valueAt(i);
+		if (!gameObject.isPendingRemoval())
+		{
+			gameObject.internalUpdate(dt);
+		}
 	}
+	--_walkDepth;
 }
 
 void GameObjectContainer::updateNotStarted()
@@ -90,8 +181,7 @@ void GameObjectContainer::updateNotStarted()
 	}
 }
 
-void GameObjectContainer::doAddGameObject(Types::GameObject::PtrType gameObject)
+bool GameObjectContainer::isWalkingGameObjects() const
 {
-	const InstanceId& instanceId = gameObject->getInstanceId();
-	_gameObjects.insert(std::pair<InstanceId, Types::GameObject::PtrType>(instanceId, std::move(gameObject)));
+	return _walkDepth > 0;
 }
\ No newline at end of file
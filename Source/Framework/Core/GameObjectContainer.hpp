@@ -11,6 +11,7 @@
 
 #include "Types.hpp"
 #include "ILifeCycle.hpp"
+#include "Framework/Utils/DenseHandleMap.hpp"
 
 namespace Framework
 {
@@ -21,8 +22,10 @@ namespace Framework
 		{
 		public:
 			GameObjectContainer() = default;
-			virtual ~GameObjectContainer() = default;
+			virtual ~GameObjectContainer();
 
+			// While our children are being walked, adds and removes wait for the next sync point,
+			// see StructuralChangeBuffer. A removed child is no longer updated in the meantime
 			virtual void addGameObject(Types::GameObject::PtrType gameObject);
 
 			bool hasGameObject(const GameObject& gameObject) const;
@@ -45,12 +48,22 @@ namespace Framework
 			void internalStart() override;
 			void internalUpdate(float dt) override;
 
+			// Detaches every child that still points back to us
+			void releaseGameObjects();
+
 		private:
+			friend class StructuralChangeBuffer;
+
 			void updateNotStarted();
-			void doAddGameObject(Types::GameObject::PtrType gameObject);
+			bool isWalkingGameObjects() const;
+			void applyAddGameObject(Types::GameObject::PtrType gameObject);
+			void applyRemoveGameObject(const InstanceId& instanceId);
 
 			std::queue<Types::GameObject::WeakPtrType> _notStartedObjects;
-			std::unordered_map<InstanceId, Types::GameObject::PtrType> _gameObjects;
+			Utils::DenseHandleMap<Types::GameObject::PtrType> _gameObjects;
+
+			uint32_t _walkDepth = 0;
+			uint32_t _numQueuedChanges = 0;
 		};
 
 #include "GameObjectContainer.inl.hpp"
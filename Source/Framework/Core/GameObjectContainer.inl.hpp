@@ -14,8 +14,8 @@ std::shared_ptr<T> GameObjectContainer::getGameObject(const Types::InstanceId& i
 template<typename T>
 std::shared_ptr<const T> GameObjectContainer::getGameObject(const Types::InstanceId& instanceId) const
 {
-	auto goMapIter = _gameObjects.find(instanceId);
-	assert(goMapIter != _gameObjects.end());
+	auto gameObjectPtr = _gameObjects.find(instanceId);
+	assert(gameObjectPtr != nullptr);
 
-	return std::dynamic_pointer_cast<T>(goMapIter->second);
+	return std::dynamic_pointer_cast<const T>(*gameObjectPtr);
 }
\ No newline at end of file
@@ -13,26 +13,13 @@
 using namespace Framework;
 using namespace Framework::Core;
 
-bool GameObjectOwner::hasOwner() const
+void GameObjectOwner::_setOwner(GameObject* gameObject)
 {
-	return _gameObject.lock() != nullptr;
+	_owner = gameObject;
 }
 
-void GameObjectOwner::_setOwner(Types::GameObject::WeakPtrType gameObject)
-{
-	_gameObject = std::move(gameObject);
-}
-
-const Core::GameObject& GameObjectOwner::getOwner() const
-{
-	auto gameObjectPtr = _gameObject.lock();
-	assert(gameObjectPtr);
-	return *gameObjectPtr;
-}
 
-Core::GameObject& GameObjectOwner::getOwner()
+void GameObjectOwner::_setPendingRemoval(bool isPendingRemoval)
 {
-	auto gameObjectPtr = _gameObject.lock();
-	assert(gameObjectPtr);
-	return *gameObjectPtr;
+	_isPendingRemoval = isPendingRemoval;
 }
\ No newline at end of file
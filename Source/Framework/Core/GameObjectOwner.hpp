@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cassert>
+
 #include "Types.hpp"
 
 namespace Framework
@@ -19,27 +21,52 @@ namespace Framework
 			GameObjectOwner() = default;
 			virtual ~GameObjectOwner() = default;
 
-			bool hasOwner() const;
+			// Inline on purpose, these sit in the hottest paths of the update and render loops
+			bool hasOwner() const
+			{
+				return _owner != nullptr;
+			}
 
-			const GameObject& getOwner() const;
-			GameObject& getOwner();
+			const GameObject& getOwner() const
+			{
+				assert(_owner);
+				return *_owner;
+			}
+			GameObject& getOwner()
+			{
+				assert(_owner);
+				return *_owner;
+			}
+
+			// The type is only checked in debug builds
 			template<typename T>
 			const T& getOwner() const
 			{
 				static_assert(std::is_base_of<GameObject, T>::value, "Object must inherit from GameObject");
-				return dynamic_cast<const T&>(getOwner());
+				assert(dynamic_cast<const T*>(&getOwner()) != nullptr);
+				return static_cast<const T&>(getOwner());
 			}
 			template<typename T>
 			T& getOwner()
 			{
 				static_assert(std::is_base_of<GameObject, T>::value, "Object must inherit from GameObject");
-				return dynamic_cast<T&>(getOwner());
+				assert(dynamic_cast<T*>(&getOwner()) != nullptr);
+				return static_cast<T&>(getOwner());
 			}
 
-			virtual void _setOwner(Types::GameObject::WeakPtrType gameObject);
+			virtual void _setOwner(GameObject* gameObject);
+
+			// Removed while its owner was walking its children, skipped until the removal is applied
+			bool isPendingRemoval() const
+			{
+				return _isPendingRemoval;
+			}
+			void _setPendingRemoval(bool isPendingRemoval);
 
 		private:
-			Types::GameObject::WeakPtrType _gameObject;
+			// Not owning. The owner holds us and clears this when it removes us or when it is destroyed
+			GameObject* _owner = nullptr;
+			bool _isPendingRemoval = false;
 		};
 	}
 }
\ No newline at end of file
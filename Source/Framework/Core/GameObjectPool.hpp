@@ -0,0 +1,92 @@
+//
+// GameObjectPool.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <utility>
+#include <type_traits>
+
+#include "Types.hpp"
+
+namespace Framework
+{
+	namespace Core
+	{
+		//
+		// Recycles game objects of one kind instead of destroying and rebuilding them. Objects keep
+		// their components, instance id and textures while they wait, so handing one out again only
+		// costs its lifecycle hooks. T provides both:
+		//
+		//     void reset();                  // Called on release, hides it and drops per-use state
+		//     void reactivate(Args...);      // Called on acquire, with the arguments given to it
+		//
+		// New objects are only built when the pool runs dry, through the create function
+		//
+		template<typename T>
+		class GameObjectPool final
+		{
+		public:
+			using PtrType = std::shared_ptr<T>;
+			using CreateFunction = std::function<PtrType()>;
+
+			explicit GameObjectPool(CreateFunction createFunction)
+				: _createFunction(std::move(createFunction))
+			{
+				static_assert(std::is_base_of<GameObject, T>::value, "Class must inherit from GameObject");
+			}
+
+			GameObjectPool(const GameObjectPool&) = delete;
+			GameObjectPool& operator=(const GameObjectPool&) = delete;
+			GameObjectPool(GameObjectPool&&) = default;
+			GameObjectPool& operator=(GameObjectPool&&) = default;
+
+			template<typename... Args>
+			PtrType acquire(Args&& ...args)
+			{
+				PtrType gameObject;
+				if (_freeObjects.empty())
+				{
+					gameObject = _createFunction();
+					_numCreated++;
+				}
+				else
+				{
+					gameObject = std::move(_freeObjects.back());
+					_freeObjects.pop_back();
+				}
+
+				gameObject->reactivate(std::forward<Args>(args)...);
+				return gameObject;
+			}
+
+			// The object may still sit in a container that removes it at the next sync point,
+			// a new owner adopting it before then takes precedence
+			void release(PtrType gameObject)
+			{
+				gameObject->reset();
+				_freeObjects.push_back(std::move(gameObject));
+			}
+
+			size_t getNumFree() const
+			{
+				return _freeObjects.size();
+			}
+
+			size_t getNumCreated() const
+			{
+				return _numCreated;
+			}
+
+		private:
+			CreateFunction _createFunction;
+			std::vector<PtrType> _freeObjects;
+			size_t _numCreated = 0;
+		};
+	}
+}
@@ -6,30 +6,60 @@
 
 #include "Instanceable.hpp"
 
+#include <mutex>
+#include <unordered_set>
+
+#include "Framework/Utils/HandleAllocator.hpp"
+
 using namespace Framework::Core;
 using namespace Framework::Types;
 
-int Instanceable::gInstanceNumber = 0;
+namespace
+{
+	Framework::Utils::HandleAllocator& GetInstanceIdAllocator()
+	{
+		static Framework::Utils::HandleAllocator allocator;
+		return allocator;
+	}
+
+	// Elements of an unordered_set never move, so the returned pointer stays valid for the whole run
+	const std::string* InternName(const std::string& name)
+	{
+		static std::mutex namesMutex;
+		static std::unordered_set<std::string> names;
+
+		std::lock_guard<std::mutex> lock(namesMutex);
+		return &*names.insert(name).first;
+	}
+}
+
+Instanceable::~Instanceable()
+{
+	if (_instanceId.isValid())
+	{
+		GetInstanceIdAllocator().release(_instanceId);
+	}
+}
 
 const InstanceId& Instanceable::getInstanceId() const
 {
 	return _instanceId;
 }
 
-void Instanceable::generateInstanceId(const std::string& classId)
+void Instanceable::generateInstanceId()
 {
-	gInstanceNumber++;
+	assert(!_instanceId.isValid());
 
-	_instanceId = classId + std::to_string(gInstanceNumber);
-	_name = _instanceId;
+	_instanceId = GetInstanceIdAllocator().allocate();
 }
 
 void Instanceable::setName(const std::string& name)
 {
-	_name = name;
+	_name = InternName(name);
 }
 
 const std::string& Instanceable::getName() const
 {
-	return _name;
+	static const std::string NoName;
+	return _name != nullptr ? *_name : NoName;
 }
\ No newline at end of file
@@ -19,19 +19,23 @@ namespace Framework
 		{
 		public:
 			Instanceable() = default;
+			virtual ~Instanceable();
+
+			Instanceable(const Instanceable&) = delete;
+			Instanceable& operator=(const Instanceable&) = delete;
 
 			const InstanceId& getInstanceId() const;
 
+			// Names are only meant for debugging and lookups by role, they are interned and empty by default
 			void setName(const std::string& name);
 			const std::string& getName() const;
 
 		protected:
-			static int gInstanceNumber;
-			void generateInstanceId(const std::string& classId);
+			void generateInstanceId();
 
 		private:
 			InstanceId _instanceId;
-			std::string _name;
+			const std::string* _name = nullptr;
 		};
 	}
-}
+}
\ No newline at end of file
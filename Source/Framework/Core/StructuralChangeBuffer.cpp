@@ -0,0 +1,165 @@
+//
+// StructuralChangeBuffer.cpp
+//
+// @author Roberto Cano
+//
+
+#include "StructuralChangeBuffer.hpp"
+
+#include "GameObject.hpp"
+
+using namespace Framework;
+using namespace Framework::Core;
+using namespace Framework::Types;
+
+StructuralChangeBuffer& StructuralChangeBuffer::Get()
+{
+	static StructuralChangeBuffer buffer;
+	return buffer;
+}
+
+#pragma region - Queueing
+void StructuralChangeBuffer::queueAddGameObject(GameObjectContainer& container, Types::GameObject::PtrType gameObject)
+{
+	Change change;
+	change.type = ChangeType::AddGameObject;
+	change.gameObjectContainer = &container;
+	change.gameObject = std::move(gameObject);
+
+	++container._numQueuedChanges;
+	_changes.push_back(std::move(change));
+}
+
+void StructuralChangeBuffer::queueRemoveGameObject(GameObjectContainer& container, const InstanceId& instanceId)
+{
+	Change change;
+	change.type = ChangeType::RemoveGameObject;
+	change.gameObjectContainer = &container;
+	change.instanceId = instanceId;
+
+	++container._numQueuedChanges;
+	_changes.push_back(std::move(change));
+}
+
+void StructuralChangeBuffer::queueAddComponent(GameComponentContainer& container, Types::GameComponent::PtrType component)
+{
+	Change change;
+	change.type = ChangeType::AddComponent;
+	change.componentContainer = &container;
+	change.component = std::move(component);
+
+	++container._numQueuedChanges;
+	_changes.push_back(std::move(change));
+}
+
+void StructuralChangeBuffer::queueRemoveComponent(GameComponentContainer& container, const InstanceId& instanceId)
+{
+	Change change;
+	change.type = ChangeType::RemoveComponent;
+	change.componentContainer = &container;
+	change.instanceId = instanceId;
+
+	++container._numQueuedChanges;
+	_changes.push_back(std::move(change));
+}
+
+void StructuralChangeBuffer::cancel(const GameObjectContainer& container)
+{
+	cancel(_changes, container);
+	cancel(_applyingChanges, container);
+}
+
+void StructuralChangeBuffer::cancel(const GameComponentContainer& container)
+{
+	cancel(_changes, container);
+	cancel(_applyingChanges, container);
+}
+
+size_t StructuralChangeBuffer::getNumQueuedChanges() const
+{
+	return _changes.size();
+}
+
+#pragma region - Sync point
+void StructuralChangeBuffer::apply()
+{
+	// A container destroyed by an earlier change cancels the rest of its own, they are nulled in place
+	while (!_changes.empty())
+	{
+		_applyingChanges.swap(_changes);
+
+		for (Change& change : _applyingChanges)
+		{
+			applyChange(change);
+		}
+		_applyingChanges.clear();
+	}
+}
+
+#pragma region - Helpers
+void StructuralChangeBuffer::cancel(std::vector<Change>& changes, const GameObjectContainer& container)
+{
+	for (Change& change : changes)
+	{
+		if (change.gameObjectContainer == &container)
+		{
+			change.gameObjectContainer = nullptr;
+			change.gameObject.reset();
+		}
+	}
+}
+
+void StructuralChangeBuffer::cancel(std::vector<Change>& changes, const GameComponentContainer& container)
+{
+	for (Change& change : changes)
+	{
+		if (change.componentContainer == &container)
+		{
+			change.componentContainer = nullptr;
+			change.component.reset();
+		}
+	}
+}
+
+void StructuralChangeBuffer::applyChange(Change& change)
+{
+	switch (change.type)
+	{
+		case ChangeType::AddGameObject:
+		{
+			if (change.gameObjectContainer != nullptr)
+			{
+				--change.gameObjectContainer->_numQueuedChanges;
+				change.gameObjectContainer->applyAddGameObject(std::move(change.gameObject));
+			}
+			break;
+		}
+		case ChangeType::RemoveGameObject:
+		{
+			if (change.gameObjectContainer != nullptr)
+			{
+				--change.gameObjectContainer->_numQueuedChanges;
+				change.gameObjectContainer->applyRemoveGameObject(change.instanceId);
+			}
+			break;
+		}
+		case ChangeType::AddComponent:
+		{
+			if (change.componentContainer != nullptr)
+			{
+				--change.componentContainer->_numQueuedChanges;
+				change.componentContainer->applyAddComponent(std::move(change.component));
+			}
+			break;
+		}
+		case ChangeType::RemoveComponent:
+		{
+			if (change.componentContainer != nullptr)
+			{
+				--change.componentContainer->_numQueuedChanges;
+				change.componentContainer->applyRemoveComponent(change.instanceId);
+			}
+			break;
+		}
+	}
+}
@@ -0,0 +1,79 @@
+//
+// StructuralChangeBuffer.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+
+#include "Types.hpp"
+
+namespace Framework
+{
+	using namespace Types;
+	namespace Core
+	{
+		class GameObjectContainer;
+		class GameComponentContainer;
+
+		//
+		// Adds and removes that target a container while it walks its children or components. The
+		// containers queue them here instead of touching the storage under the loop, and the engine
+		// applies the whole batch at its sync points, once the walk is over. Changes are applied in
+		// the order they were queued, so a remove followed by an add behaves as if done immediately
+		//
+		class StructuralChangeBuffer final
+		{
+		public:
+			static StructuralChangeBuffer& Get();
+
+			StructuralChangeBuffer(const StructuralChangeBuffer&) = delete;
+			StructuralChangeBuffer& operator=(const StructuralChangeBuffer&) = delete;
+
+			void queueAddGameObject(GameObjectContainer& container, Types::GameObject::PtrType gameObject);
+			void queueRemoveGameObject(GameObjectContainer& container, const InstanceId& instanceId);
+			void queueAddComponent(GameComponentContainer& container, Types::GameComponent::PtrType component);
+			void queueRemoveComponent(GameComponentContainer& container, const InstanceId& instanceId);
+
+			// Drops the changes of a container that is going away
+			void cancel(const GameObjectContainer& container);
+			void cancel(const GameComponentContainer& container);
+
+			// Sync point, nothing may be walking the tree
+			void apply();
+
+			size_t getNumQueuedChanges() const;
+
+		private:
+			enum class ChangeType
+			{
+				AddGameObject,
+				RemoveGameObject,
+				AddComponent,
+				RemoveComponent
+			};
+
+			struct Change
+			{
+				ChangeType type;
+				GameObjectContainer* gameObjectContainer = nullptr;
+				GameComponentContainer* componentContainer = nullptr;
+				Types::GameObject::PtrType gameObject;
+				Types::GameComponent::PtrType component;
+				InstanceId instanceId;
+			};
+
+			StructuralChangeBuffer() = default;
+
+			void cancel(std::vector<Change>& changes, const GameObjectContainer& container);
+			void cancel(std::vector<Change>& changes, const GameComponentContainer& container);
+			void applyChange(Change& change);
+
+			std::vector<Change> _changes;
+			// The batch being applied, a container dying in the middle still has to cancel in here
+			std::vector<Change> _applyingChanges;
+		};
+	}
+}
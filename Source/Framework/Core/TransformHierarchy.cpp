@@ -0,0 +1,367 @@
+//
+// TransformHierarchy.cpp
+//
+// @author Roberto Cano
+//
+
+#include "TransformHierarchy.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+using namespace Framework;
+using namespace Framework::Core;
+using namespace Framework::Types;
+
+namespace
+{
+	template<typename T>
+	void Permute(std::vector<T>& values, const std::vector<uint32_t>& order)
+	{
+		std::vector<T> permuted;
+		permuted.reserve(order.size());
+		for (uint32_t oldSlot : order)
+		{
+			permuted.push_back(values[oldSlot]);
+		}
+		values.swap(permuted);
+	}
+}
+
+#pragma region - Nodes
+TransformHierarchy::NodeId TransformHierarchy::createNode()
+{
+	NodeId node;
+	if (!_freeNodes.empty())
+	{
+		node = _freeNodes.back();
+		_freeNodes.pop_back();
+	}
+	else
+	{
+		node = static_cast<NodeId>(_slotsByNode.size());
+		_slotsByNode.push_back(InvalidSlot);
+	}
+
+	// New nodes are roots, appending them keeps the order valid
+	const uint32_t slot = static_cast<uint32_t>(_nodesBySlot.size());
+	_slotsByNode[node] = slot;
+
+	_parentSlots.push_back(InvalidSlot);
+	_nodesBySlot.push_back(node);
+	_dirtyFlags.push_back(1);
+	_hasDirtyNodes = true;
+	_localX.push_back(0.0f);
+	_localY.push_back(0.0f);
+	_localRotation.push_back(0.0f);
+	_localScale.push_back(1.0f);
+	_localA.push_back(1.0f);
+	_localB.push_back(0.0f);
+	_worldX.push_back(0.0f);
+	_worldY.push_back(0.0f);
+	_worldRotation.push_back(0.0f);
+	_worldScale.push_back(1.0f);
+	_worldA.push_back(1.0f);
+	_worldB.push_back(0.0f);
+
+	return node;
+}
+
+void TransformHierarchy::destroyNode(NodeId node)
+{
+	const uint32_t slot = getSlot(node);
+
+	// The slot stays dead until the next relayout compacts it away
+	_nodesBySlot[slot] = InvalidNode;
+	_parentSlots[slot] = InvalidSlot;
+	_slotsByNode[node] = InvalidSlot;
+	_freeNodes.push_back(node);
+
+	_isLayoutDirty = true;
+}
+
+void TransformHierarchy::setParent(NodeId node, NodeId parent)
+{
+	const uint32_t slot = getSlot(node);
+	const uint32_t parentSlot = parent != InvalidNode ? getSlot(parent) : InvalidSlot;
+	assert(parentSlot != slot);
+
+	_parentSlots[slot] = parentSlot;
+	if (parentSlot != InvalidSlot && parentSlot > slot)
+	{
+		_isLayoutDirty = true;
+	}
+
+	markDirty(slot);
+}
+
+size_t TransformHierarchy::getNumNodes() const
+{
+	return _nodesBySlot.size() - std::count(_nodesBySlot.begin(), _nodesBySlot.end(), InvalidNode);
+}
+
+#pragma region - Local transform
+void TransformHierarchy::setLocalPosition(NodeId node, const Point2D& position)
+{
+	const uint32_t slot = getSlot(node);
+	_localX[slot] = position.x;
+	_localY[slot] = position.y;
+	markDirty(slot);
+}
+
+Point2D TransformHierarchy::getLocalPosition(NodeId node) const
+{
+	const uint32_t slot = getSlot(node);
+	return Point2D(_localX[slot], _localY[slot]);
+}
+
+void TransformHierarchy::setLocalRotation(NodeId node, float radians)
+{
+	const uint32_t slot = getSlot(node);
+	_localRotation[slot] = radians;
+	setLocalLinear(slot);
+	markDirty(slot);
+}
+
+float TransformHierarchy::getLocalRotation(NodeId node) const
+{
+	return _localRotation[getSlot(node)];
+}
+
+void TransformHierarchy::setLocalScale(NodeId node, float scale)
+{
+	const uint32_t slot = getSlot(node);
+	_localScale[slot] = scale;
+	setLocalLinear(slot);
+	markDirty(slot);
+}
+
+float TransformHierarchy::getLocalScale(NodeId node) const
+{
+	return _localScale[getSlot(node)];
+}
+
+#pragma region - World transform
+void TransformHierarchy::setWorldPosition(NodeId node, const Point2D& position)
+{
+	const uint32_t slot = getSlot(node);
+	const uint32_t parentSlot = _parentSlots[slot];
+
+	if (parentSlot == InvalidSlot)
+	{
+		setLocalPosition(node, position);
+		return;
+	}
+
+	resolveBranch(parentSlot);
+
+	// Inverse of the parent similarity, [a b; -b a] / (a^2 + b^2)
+	const float a = _worldA[parentSlot];
+	const float b = _worldB[parentSlot];
+	const float determinant = a * a + b * b;
+	const float dx = position.x - _worldX[parentSlot];
+	const float dy = position.y - _worldY[parentSlot];
+
+	if (determinant > 0.0f)
+	{
+		setLocalPosition(node, Point2D((a * dx + b * dy) / determinant, (a * dy - b * dx) / determinant));
+	}
+	else
+	{
+		// A parent scaled to nothing collapses every child onto itself
+		setLocalPosition(node, Point2D(0.0f, 0.0f));
+	}
+}
+
+void TransformHierarchy::updateWorldTransforms()
+{
+	if (_isLayoutDirty)
+	{
+		relayout();
+	}
+
+	// Called again before every parallel phase, most of those calls find nothing to do
+	if (!_hasDirtyNodes)
+	{
+		return;
+	}
+
+	// Parents come first, so their flags and world values are final when their children are reached
+	const size_t numSlots = _parentSlots.size();
+	for (size_t slot = 0; slot < numSlots; ++slot)
+	{
+		const uint32_t parentSlot = _parentSlots[slot];
+		if (parentSlot != InvalidSlot)
+		{
+			_dirtyFlags[slot] |= _dirtyFlags[parentSlot];
+		}
+
+		if (_dirtyFlags[slot])
+		{
+			resolveSlot(static_cast<uint32_t>(slot));
+		}
+	}
+
+	std::fill(_dirtyFlags.begin(), _dirtyFlags.end(), 0);
+	_hasDirtyNodes = false;
+}
+
+#pragma region - Helpers
+void TransformHierarchy::markDirty(uint32_t slot)
+{
+	_dirtyFlags[slot] = 1;
+	_hasDirtyNodes = true;
+}
+
+void TransformHierarchy::setLocalLinear(uint32_t slot)
+{
+	_localA[slot] = _localScale[slot] * std::cos(_localRotation[slot]);
+	_localB[slot] = _localScale[slot] * std::sin(_localRotation[slot]);
+}
+
+void TransformHierarchy::resolveBranch(uint32_t slot)
+{
+	// Branches are shallow, checking the way up is cheaper than keeping child flags up to date
+	bool isDirty = false;
+	for (uint32_t current = slot; current != InvalidSlot; current = _parentSlots[current])
+	{
+		if (_dirtyFlags[current])
+		{
+			isDirty = true;
+			break;
+		}
+	}
+
+	if (isDirty)
+	{
+		// Flags are left set, the next full pass still has to reach the rest of the branch
+		const uint32_t parentSlot = _parentSlots[slot];
+		if (parentSlot != InvalidSlot)
+		{
+			resolveBranch(parentSlot);
+		}
+		resolveSlot(slot);
+	}
+}
+
+void TransformHierarchy::resolveSlot(uint32_t slot)
+{
+	const uint32_t parentSlot = _parentSlots[slot];
+	if (parentSlot != InvalidSlot)
+	{
+		composeWithParent(slot, parentSlot);
+	}
+	else
+	{
+		_worldX[slot] = _localX[slot];
+		_worldY[slot] = _localY[slot];
+		_worldRotation[slot] = _localRotation[slot];
+		_worldScale[slot] = _localScale[slot];
+		_worldA[slot] = _localA[slot];
+		_worldB[slot] = _localB[slot];
+	}
+}
+
+void TransformHierarchy::composeWithParent(uint32_t slot, uint32_t parentSlot)
+{
+	const float parentA = _worldA[parentSlot];
+	const float parentB = _worldB[parentSlot];
+	const float localX = _localX[slot];
+	const float localY = _localY[slot];
+	const float localA = _localA[slot];
+	const float localB = _localB[slot];
+
+	_worldX[slot] = _worldX[parentSlot] + parentA * localX - parentB * localY;
+	_worldY[slot] = _worldY[parentSlot] + parentB * localX + parentA * localY;
+	_worldA[slot] = parentA * localA - parentB * localB;
+	_worldB[slot] = parentB * localA + parentA * localB;
+	_worldRotation[slot] = _worldRotation[parentSlot] + _localRotation[slot];
+	_worldScale[slot] = _worldScale[parentSlot] * _localScale[slot];
+}
+
+void TransformHierarchy::relayout()
+{
+	const uint32_t numSlots = static_cast<uint32_t>(_parentSlots.size());
+
+	// Intrusive child lists over the current slots
+	std::vector<uint32_t> firstChild(numSlots, InvalidSlot);
+	std::vector<uint32_t> nextSibling(numSlots, InvalidSlot);
+	std::vector<uint32_t> order;
+	order.reserve(numSlots);
+
+	for (uint32_t slot = numSlots; slot > 0; --slot)
+	{
+		const uint32_t current = slot - 1;
+		if (_nodesBySlot[current] == InvalidNode)
+		{
+			continue;
+		}
+
+		// Children of a dead node become roots
+		const uint32_t parentSlot = _parentSlots[current];
+		if (parentSlot == InvalidSlot || _nodesBySlot[parentSlot] == InvalidNode)
+		{
+			_parentSlots[current] = InvalidSlot;
+			_dirtyFlags[current] = 1;
+			continue;
+		}
+
+		nextSibling[current] = firstChild[parentSlot];
+		firstChild[parentSlot] = current;
+	}
+
+	for (uint32_t slot = 0; slot < numSlots; ++slot)
+	{
+		if (_nodesBySlot[slot] != InvalidNode && _parentSlots[slot] == InvalidSlot)
+		{
+			order.push_back(slot);
+		}
+	}
+
+	// Breadth first, the order vector doubles as the queue
+	for (size_t position = 0; position < order.size(); ++position)
+	{
+		for (uint32_t child = firstChild[order[position]]; child != InvalidSlot; child = nextSibling[child])
+		{
+			order.push_back(child);
+		}
+	}
+
+	std::vector<uint32_t> newSlots(numSlots, InvalidSlot);
+	for (uint32_t newSlot = 0; newSlot < order.size(); ++newSlot)
+	{
+		newSlots[order[newSlot]] = newSlot;
+	}
+
+	for (uint32_t& parentSlot : _parentSlots)
+	{
+		if (parentSlot != InvalidSlot)
+		{
+			parentSlot = newSlots[parentSlot];
+		}
+	}
+
+	Permute(_parentSlots, order);
+	Permute(_nodesBySlot, order);
+	Permute(_dirtyFlags, order);
+	Permute(_localX, order);
+	Permute(_localY, order);
+	Permute(_localRotation, order);
+	Permute(_localScale, order);
+	Permute(_localA, order);
+	Permute(_localB, order);
+	Permute(_worldX, order);
+	Permute(_worldY, order);
+	Permute(_worldRotation, order);
+	Permute(_worldScale, order);
+	Permute(_worldA, order);
+	Permute(_worldB, order);
+
+	for (uint32_t slot = 0; slot < _nodesBySlot.size(); ++slot)
+	{
+		_slotsByNode[_nodesBySlot[slot]] = slot;
+	}
+
+	_isLayoutDirty = false;
+}
@@ -0,0 +1,148 @@
+//
+// TransformHierarchy.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+#include "Types.hpp"
+
+namespace Framework
+{
+	using namespace Types;
+	namespace Core
+	{
+		//
+		// Transforms of every game object, kept as parallel arrays laid out breadth first so parents
+		// always come before their children. Setters only write the local values and flag the node,
+		// updateWorldTransforms() then resolves the whole hierarchy in one linear pass. Reading a
+		// world value of a flagged branch in between resolves only that branch.
+		//
+		// Transforms are 2D similarities (translation, rotation and uniform scale). The world matrix
+		// is cached as its translation plus the (a, b) pair of the [a -b; b a] linear part, so the
+		// pass needs no trigonometry
+		//
+		class TransformHierarchy final
+		{
+		public:
+			using NodeId = uint32_t;
+			static constexpr NodeId InvalidNode = 0xFFFFFFFF;
+
+			// Inline on purpose, with the world getters below it is on every render path read
+			static TransformHierarchy& Get()
+			{
+				static TransformHierarchy hierarchy;
+				return hierarchy;
+			}
+
+			TransformHierarchy(const TransformHierarchy&) = delete;
+			TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+			NodeId createNode();
+			void destroyNode(NodeId node);
+
+			// Local values are kept, the world ones follow the new parent
+			void setParent(NodeId node, NodeId parent);
+
+			void setLocalPosition(NodeId node, const Point2D& position);
+			Point2D getLocalPosition(NodeId node) const;
+			void setLocalRotation(NodeId node, float radians);
+			float getLocalRotation(NodeId node) const;
+			void setLocalScale(NodeId node, float scale);
+			float getLocalScale(NodeId node) const;
+
+			void setWorldPosition(NodeId node, const Point2D& position);
+
+			// Inline on purpose: after updateWorldTransforms() nothing is flagged until the next
+			// setter, and reading is a slot lookup and a couple of loads
+			Point2D getWorldPosition(NodeId node)
+			{
+				const uint32_t slot = getResolvedSlot(node);
+				return Point2D(_worldX[slot], _worldY[slot]);
+			}
+			float getWorldRotation(NodeId node)
+			{
+				return _worldRotation[getResolvedSlot(node)];
+			}
+			float getWorldScale(NodeId node)
+			{
+				return _worldScale[getResolvedSlot(node)];
+			}
+
+			// Maps a point in the node space to world space
+			Point2D localToWorld(NodeId node, const Point2D& localPoint)
+			{
+				const uint32_t slot = getResolvedSlot(node);
+				const float a = _worldA[slot];
+				const float b = _worldB[slot];
+				return Point2D(_worldX[slot] + a * localPoint.x - b * localPoint.y, _worldY[slot] + b * localPoint.x + a * localPoint.y);
+			}
+
+			void updateWorldTransforms();
+
+			size_t getNumNodes() const;
+
+		private:
+			static constexpr uint32_t InvalidSlot = 0xFFFFFFFF;
+
+			TransformHierarchy() = default;
+
+			uint32_t getSlot(NodeId node) const
+			{
+				assert(node < _slotsByNode.size());
+
+				const uint32_t slot = _slotsByNode[node];
+				assert(slot != InvalidSlot);
+				return slot;
+			}
+			// Writes into the hierarchy while there are dirty nodes, only safe to call from
+			// several threads once updateWorldTransforms() has run
+			uint32_t getResolvedSlot(NodeId node)
+			{
+				const uint32_t slot = getSlot(node);
+				if (_hasDirtyNodes)
+				{
+					resolveBranch(slot);
+				}
+				return slot;
+			}
+			void markDirty(uint32_t slot);
+			void setLocalLinear(uint32_t slot);
+			void resolveBranch(uint32_t slot);
+			void resolveSlot(uint32_t slot);
+			void composeWithParent(uint32_t slot, uint32_t parentSlot);
+			void relayout();
+
+			// Indexed by slot, in breadth first order once relaid out
+			std::vector<uint32_t> _parentSlots;
+			std::vector<NodeId> _nodesBySlot;
+			std::vector<uint8_t> _dirtyFlags;
+			std::vector<float> _localX;
+			std::vector<float> _localY;
+			std::vector<float> _localRotation;
+			std::vector<float> _localScale;
+			std::vector<float> _localA;
+			std::vector<float> _localB;
+			std::vector<float> _worldX;
+			std::vector<float> _worldY;
+			std::vector<float> _worldRotation;
+			std::vector<float> _worldScale;
+			std::vector<float> _worldA;
+			std::vector<float> _worldB;
+
+			// Indexed by node id
+			std::vector<uint32_t> _slotsByNode;
+			std::vector<NodeId> _freeNodes;
+
+			// A parent was attached after its child or a node died, the order has to be rebuilt
+			bool _isLayoutDirty = false;
+			// Any flag set since the last pass, the world getters skip resolving while it is clear
+			bool _hasDirtyNodes = false;
+		};
+	}
+}
@@ -8,6 +8,8 @@
 
 #include <string>
 #include <functional>
+#include <memory>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 
@@ -33,9 +35,34 @@ namespace Framework
 
 	namespace Types
 	{
-		using ComponentId = std::string;
-		using InstanceId = std::string;
-		using InstanceIdInvalid = std::string();
+		// Small dense integer per component class, see Utils::GetComponentIdFromClass
+		using ComponentId = uint32_t;
+
+		// Generational handle. Indices are recycled once an instance dies, the generation tells the old and new owners apart
+		struct InstanceId
+		{
+			static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+			uint32_t index = InvalidIndex;
+			uint32_t generation = 0;
+
+			bool isValid() const
+			{
+				return index != InvalidIndex;
+			}
+			bool operator==(const InstanceId& other) const
+			{
+				return index == other.index && generation == other.generation;
+			}
+			bool operator!=(const InstanceId& other) const
+			{
+				return !(*this == other);
+			}
+			bool operator<(const InstanceId& other) const
+			{
+				return index < other.index || (index == other.index && generation < other.generation);
+			}
+		};
 
 		using Point2D = glm::vec2;
 		using Direction2D = glm::vec2;
@@ -43,6 +70,8 @@ namespace Framework
 		using Color3D = glm::vec3;
 
 		using TextureId = uint32_t;
+		using FontId = uint32_t;
+		using TextLayoutId = uint32_t;
 
 		using Size2D = glm::vec2;
 		struct Size
@@ -114,3 +143,15 @@ namespace Framework
 		using Callback = std::function<void(Args...)>;
 	}
 }
+
+namespace std
+{
+	template<>
+	struct hash<Framework::Types::InstanceId>
+	{
+		size_t operator()(const Framework::Types::InstanceId& instanceId) const
+		{
+			return hash<uint64_t>()((static_cast<uint64_t>(instanceId.generation) << 32) | instanceId.index);
+		}
+	};
+}
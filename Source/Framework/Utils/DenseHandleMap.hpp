@@ -0,0 +1,200 @@
+//
+// DenseHandleMap.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+
+#include "Framework/Core/Types.hpp"
+
+namespace Framework
+{
+	namespace Utils
+	{
+		//
+		// Map keyed by generational handles. Values are packed in a dense array that is cheap to
+		// iterate. Small maps, which is most of them, find a handle with a linear search over the
+		// dense ids. Past LinearSearchLimit values the map switches to a paged sparse array indexed
+		// by the handle index, allocating only the pages that hold a key, and keeps it from then on.
+		// Erasing moves the last value into the hole, so the order of the dense array is not stable
+		//
+		template<typename T>
+		class DenseHandleMap final
+		{
+		public:
+			DenseHandleMap() = default;
+
+			bool insert(const Types::InstanceId& instanceId, T value)
+			{
+				assert(instanceId.isValid());
+
+				if (findSlot(instanceId) != InvalidSlot)
+				{
+					return false;
+				}
+
+				const uint32_t slot = static_cast<uint32_t>(_denseIds.size());
+				_denseIds.push_back(instanceId);
+				_denseValues.push_back(std::move(value));
+
+				if (!_sparsePages.empty())
+				{
+					getOrCreateSlot(instanceId.index) = slot;
+				}
+				else if (_denseIds.size() > LinearSearchLimit)
+				{
+					buildSparsePages();
+				}
+				return true;
+			}
+
+			bool erase(const Types::InstanceId& instanceId)
+			{
+				const uint32_t slot = findSlot(instanceId);
+				if (slot == InvalidSlot)
+				{
+					return false;
+				}
+
+				const bool hasSparsePages = !_sparsePages.empty();
+				const uint32_t lastSlot = static_cast<uint32_t>(_denseIds.size() - 1);
+				if (slot != lastSlot)
+				{
+					_denseIds[slot] = _denseIds[lastSlot];
+					_denseValues[slot] = std::move(_denseValues[lastSlot]);
+					if (hasSparsePages)
+					{
+						getOrCreateSlot(_denseIds[slot].index) = slot;
+					}
+				}
+
+				if (hasSparsePages)
+				{
+					getOrCreateSlot(instanceId.index) = InvalidSlot;
+				}
+				_denseIds.pop_back();
+				_denseValues.pop_back();
+				return true;
+			}
+
+			T* find(const Types::InstanceId& instanceId)
+			{
+				const uint32_t slot = findSlot(instanceId);
+				return slot != InvalidSlot ? &_denseValues[slot] : nullptr;
+			}
+
+			const T* find(const Types::InstanceId& instanceId) const
+			{
+				const uint32_t slot = findSlot(instanceId);
+				return slot != InvalidSlot ? &_denseValues[slot] : nullptr;
+			}
+
+			bool contains(const Types::InstanceId& instanceId) const
+			{
+				return findSlot(instanceId) != InvalidSlot;
+			}
+
+			size_t size() const
+			{
+				return _denseValues.size();
+			}
+
+			bool empty() const
+			{
+				return _denseValues.empty();
+			}
+
+			// Dense positions, only valid until the next insert or erase
+			T& valueAt(size_t position)
+			{
+				return _denseValues[position];
+			}
+
+			const T& valueAt(size_t position) const
+			{
+				return _denseValues[position];
+			}
+
+			const Types::InstanceId& idAt(size_t position) const
+			{
+				return _denseIds[position];
+			}
+
+		private:
+			// A few cache lines of ids, a scan over them beats chasing a page
+			static constexpr size_t LinearSearchLimit = 32;
+			static constexpr uint32_t PageBits = 8;
+			static constexpr uint32_t PageSize = 1 << PageBits;
+			static constexpr uint32_t InvalidSlot = 0xFFFFFFFF;
+
+			uint32_t findSlot(const Types::InstanceId& instanceId) const
+			{
+				if (!instanceId.isValid())
+				{
+					return InvalidSlot;
+				}
+
+				if (_sparsePages.empty())
+				{
+					for (size_t slot = 0; slot < _denseIds.size(); ++slot)
+					{
+						if (_denseIds[slot] == instanceId)
+						{
+							return static_cast<uint32_t>(slot);
+						}
+					}
+					return InvalidSlot;
+				}
+
+				const uint32_t page = instanceId.index >> PageBits;
+				if (page >= _sparsePages.size() || !_sparsePages[page])
+				{
+					return InvalidSlot;
+				}
+
+				// A stale handle shares the index with the live one but not the generation
+				const uint32_t slot = _sparsePages[page][instanceId.index & (PageSize - 1)];
+				if (slot == InvalidSlot || _denseIds[slot] != instanceId)
+				{
+					return InvalidSlot;
+				}
+				return slot;
+			}
+
+			void buildSparsePages()
+			{
+				for (size_t slot = 0; slot < _denseIds.size(); ++slot)
+				{
+					getOrCreateSlot(_denseIds[slot].index) = static_cast<uint32_t>(slot);
+				}
+			}
+
+			uint32_t& getOrCreateSlot(uint32_t index)
+			{
+				const uint32_t page = index >> PageBits;
+				if (page >= _sparsePages.size())
+				{
+					_sparsePages.resize(page + 1);
+				}
+
+				std::unique_ptr<uint32_t[]>& pageSlots = _sparsePages[page];
+				if (!pageSlots)
+				{
+					pageSlots.reset(new uint32_t[PageSize]);
+					std::fill(pageSlots.get(), pageSlots.get() + PageSize, InvalidSlot);
+				}
+				return pageSlots[index & (PageSize - 1)];
+			}
+
+			std::vector<std::unique_ptr<uint32_t[]>> _sparsePages;
+			std::vector<Types::InstanceId> _denseIds;
+			std::vector<T> _denseValues;
+		};
+	}
+}
@@ -0,0 +1,43 @@
+//
+// HandleAllocator.cpp
+//
+// @author Roberto Cano
+//
+
+#include "HandleAllocator.hpp"
+
+#include <cassert>
+
+using namespace Framework::Utils;
+using namespace Framework::Types;
+
+InstanceId HandleAllocator::allocate()
+{
+	{
+		std::lock_guard<std::mutex> lock(_freeListMutex);
+		if (!_freeList.empty())
+		{
+			const InstanceId instanceId = _freeList.back();
+			_freeList.pop_back();
+			return instanceId;
+		}
+	}
+
+	InstanceId instanceId;
+	instanceId.index = _nextIndex.fetch_add(1, std::memory_order_relaxed);
+	assert(instanceId.index != InstanceId::InvalidIndex);
+
+	return instanceId;
+}
+
+void HandleAllocator::release(const InstanceId& instanceId)
+{
+	assert(instanceId.isValid());
+
+	// Any handle still pointing at the old generation stops matching from now on
+	InstanceId recycled = instanceId;
+	recycled.generation++;
+
+	std::lock_guard<std::mutex> lock(_freeListMutex);
+	_freeList.push_back(recycled);
+}
@@ -0,0 +1,40 @@
+//
+// HandleAllocator.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+#include "Framework/Core/Types.hpp"
+
+namespace Framework
+{
+	namespace Utils
+	{
+		//
+		// Hands out generational handles. Released indices go to a free list with their generation
+		// bumped, fresh indices come from an atomic counter so allocation is safe from any thread
+		//
+		class HandleAllocator final
+		{
+		public:
+			HandleAllocator() = default;
+
+			HandleAllocator(const HandleAllocator&) = delete;
+			HandleAllocator& operator=(const HandleAllocator&) = delete;
+
+			Types::InstanceId allocate();
+			void release(const Types::InstanceId& instanceId);
+
+		private:
+			std::atomic<uint32_t> _nextIndex{ 0 };
+			std::mutex _freeListMutex;
+			std::vector<Types::InstanceId> _freeList;
+		};
+	}
+}
@@ -0,0 +1,206 @@
+//
+// JobSystem.cpp
+//
+// @author Roberto Cano
+//
+
+#include "JobSystem.hpp"
+
+#include <cassert>
+#include <algorithm>
+
+using namespace Framework::Utils;
+
+namespace
+{
+	// Lets a worker find its own queue, threads outside any pool see a null system
+	thread_local const JobSystem* CurrentJobSystem = nullptr;
+	thread_local uint32_t CurrentQueueIndex = 0;
+}
+
+bool JobSystem::JobGroup::isDone() const
+{
+	return _numPending.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem(uint32_t numWorkers)
+{
+	_queues.reserve(numWorkers + 1);
+	for (uint32_t i = 0; i < numWorkers + 1; ++i)
+	{
+		_queues.emplace_back(std::make_unique<WorkQueue>());
+	}
+
+	_workers.reserve(numWorkers);
+	for (uint32_t i = 0; i < numWorkers; ++i)
+	{
+		_workers.emplace_back(&JobSystem::workerMain, this, i + 1);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+		_isRunning = false;
+	}
+	_wakeCondition.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		worker.join();
+	}
+}
+
+uint32_t JobSystem::getNumThreads() const
+{
+	return static_cast<uint32_t>(_workers.size() + 1);
+}
+
+void JobSystem::run(JobGroup& group, Job job)
+{
+	group._numPending.fetch_add(1, std::memory_order_relaxed);
+
+	WorkQueue& queue = *_queues[getCurrentQueueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back({ std::move(job), &group });
+	}
+	_numQueuedJobs.fetch_add(1, std::memory_order_release);
+
+	// Taking the lock orders this against a worker that is about to sleep, the wake-up cannot be lost
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+	}
+	_wakeCondition.notify_one();
+}
+
+void JobSystem::wait(JobGroup& group)
+{
+	const uint32_t queueIndex = getCurrentQueueIndex();
+
+	QueuedJob job;
+	while (!group.isDone())
+	{
+		if (findJob(queueIndex, job))
+		{
+			execute(job);
+		}
+		else
+		{
+			// The remaining jobs are running on other threads
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const RangeJob& rangeJob)
+{
+	assert(grainSize > 0);
+
+	const size_t numChunks = (count + grainSize - 1) / grainSize;
+	if (numChunks == 0)
+	{
+		return;
+	}
+
+	if (numChunks == 1 || _workers.empty())
+	{
+		for (size_t chunk = 0; chunk < numChunks; ++chunk)
+		{
+			const size_t begin = chunk * grainSize;
+			rangeJob(chunk, begin, std::min(begin + grainSize, count));
+		}
+		return;
+	}
+
+	JobGroup group;
+	for (size_t chunk = 0; chunk < numChunks; ++chunk)
+	{
+		const size_t begin = chunk * grainSize;
+		const size_t end = std::min(begin + grainSize, count);
+		run(group, [&rangeJob, chunk, begin, end]()
+		{
+			rangeJob(chunk, begin, end);
+		});
+	}
+	wait(group);
+}
+
+void JobSystem::workerMain(uint32_t queueIndex)
+{
+	CurrentJobSystem = this;
+	CurrentQueueIndex = queueIndex;
+
+	QueuedJob job;
+	for (;;)
+	{
+		if (findJob(queueIndex, job))
+		{
+			execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_wakeMutex);
+		_wakeCondition.wait(lock, [this]()
+		{
+			return !_isRunning || _numQueuedJobs.load(std::memory_order_acquire) > 0;
+		});
+
+		if (!_isRunning)
+		{
+			return;
+		}
+	}
+}
+
+uint32_t JobSystem::getCurrentQueueIndex() const
+{
+	return CurrentJobSystem == this ? CurrentQueueIndex : 0;
+}
+
+bool JobSystem::findJob(uint32_t queueIndex, QueuedJob& job)
+{
+	if (_numQueuedJobs.load(std::memory_order_acquire) == 0)
+	{
+		return false;
+	}
+
+	// Own queue first, newest job while its data is still warm
+	{
+		WorkQueue& queue = *_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty())
+		{
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			_numQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	// Then steal the oldest job of someone else
+	const size_t numQueues = _queues.size();
+	for (size_t offset = 1; offset < numQueues; ++offset)
+	{
+		WorkQueue& queue = *_queues[(queueIndex + offset) % numQueues];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty())
+		{
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			_numQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::execute(QueuedJob& job)
+{
+	job.job();
+	job.job = nullptr;
+
+	job.group->_numPending.fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,96 @@
+//
+// JobSystem.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace Framework
+{
+	namespace Utils
+	{
+		//
+		// Work-stealing thread pool. Every worker owns a queue: it pops its own jobs from the back and,
+		// once it runs dry, steals from the front of the others. Threads outside the pool share one
+		// extra queue. Waiting on a group runs queued jobs instead of blocking, so the calling thread
+		// works too and nested waits cannot deadlock
+		//
+		class JobSystem final
+		{
+		public:
+			using Job = std::function<void()>;
+			// Chunk index, first and one past the last element of the chunk
+			using RangeJob = std::function<void(size_t, size_t, size_t)>;
+
+			// Counts the jobs of a batch still to finish
+			class JobGroup final
+			{
+			public:
+				JobGroup() = default;
+
+				JobGroup(const JobGroup&) = delete;
+				JobGroup& operator=(const JobGroup&) = delete;
+
+				bool isDone() const;
+
+			private:
+				friend class JobSystem;
+
+				std::atomic<uint32_t> _numPending{ 0 };
+			};
+
+			explicit JobSystem(uint32_t numWorkers);
+			~JobSystem();
+
+			JobSystem(const JobSystem&) = delete;
+			JobSystem& operator=(const JobSystem&) = delete;
+
+			// Workers plus the thread that waits
+			uint32_t getNumThreads() const;
+
+			void run(JobGroup& group, Job job);
+			void wait(JobGroup& group);
+
+			// Splits [0, count) in chunks of grainSize elements and blocks until all of them are done.
+			// Chunk boundaries only depend on the arguments, never on the number of threads
+			void parallelFor(size_t count, size_t grainSize, const RangeJob& rangeJob);
+
+		private:
+			struct QueuedJob
+			{
+				Job job;
+				JobGroup* group = nullptr;
+			};
+
+			struct WorkQueue
+			{
+				std::mutex mutex;
+				std::deque<QueuedJob> jobs;
+			};
+
+			void workerMain(uint32_t queueIndex);
+			uint32_t getCurrentQueueIndex() const;
+			bool findJob(uint32_t queueIndex, QueuedJob& job);
+			void execute(QueuedJob& job);
+
+			// Queue 0 belongs to the threads outside the pool, worker i owns queue i + 1
+			std::vector<std::unique_ptr<WorkQueue>> _queues;
+			std::vector<std::thread> _workers;
+			std::atomic<uint32_t> _numQueuedJobs{ 0 };
+
+			std::mutex _wakeMutex;
+			std::condition_variable _wakeCondition;
+			bool _isRunning = true;
+		};
+	}
+}
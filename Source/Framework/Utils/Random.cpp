@@ -0,0 +1,264 @@
+//
+// Random.cpp
+//
+// @author Roberto Cano
+//
+
+#include "Random.hpp"
+
+#include <cassert>
+#include <atomic>
+#include <random>
+
+using namespace Framework::Utils;
+
+namespace RandomConstants
+{
+	const uint64_t DefaultSeed = 0x853C49E6748FEA9BULL;
+	const float FloatUnit = 1.0f / 16777216.0f;	// 2^-24, a float holds 24 significant bits
+	const uint32_t UnseededGeneration = 0xFFFFFFFF;
+}
+
+namespace
+{
+	std::atomic<uint64_t> GlobalSeed{ RandomConstants::DefaultSeed };
+	// Bumped on every SetSeed(), threads holding an older generator reseed on their next Get()
+	std::atomic<uint32_t> SeedGeneration{ 0 };
+	std::atomic<uint64_t> NextThreadStream{ 1 };
+
+	struct ThreadRandom
+	{
+		Random random{ RandomConstants::DefaultSeed };
+		uint32_t generation = RandomConstants::UnseededGeneration;
+		uint64_t stream = 0;
+	};
+
+	thread_local ThreadRandom CurrentThreadRandom;
+
+	uint64_t SplitMix64(uint64_t& state)
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	uint64_t GetStreamSeed(uint64_t seed, uint64_t stream)
+	{
+		// Stream 0 is the seeding thread, the others are decorrelated through splitmix
+		if (stream == 0)
+		{
+			return seed;
+		}
+
+		uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+		return SplitMix64(state);
+	}
+}
+
+Random::Random(uint64_t seed)
+{
+	this->seed(seed);
+}
+
+Random& Random::Get()
+{
+	ThreadRandom& threadRandom = CurrentThreadRandom;
+
+	const uint32_t generation = SeedGeneration.load(std::memory_order_acquire);
+	if (threadRandom.generation != generation)
+	{
+		if (threadRandom.generation == RandomConstants::UnseededGeneration)
+		{
+			threadRandom.stream = NextThreadStream.fetch_add(1, std::memory_order_relaxed);
+		}
+		threadRandom.random.seed(GetStreamSeed(GlobalSeed.load(std::memory_order_relaxed), threadRandom.stream));
+		threadRandom.generation = generation;
+	}
+
+	return threadRandom.random;
+}
+
+uint64_t Random::SetSeed(uint64_t seed)
+{
+	if (seed == 0)
+	{
+		std::random_device randomDevice;
+		seed = (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+	}
+
+	GlobalSeed.store(seed, std::memory_order_relaxed);
+	const uint32_t generation = SeedGeneration.fetch_add(1, std::memory_order_release) + 1;
+
+	// The calling thread takes the seed as is
+	ThreadRandom& threadRandom = CurrentThreadRandom;
+	threadRandom.stream = 0;
+	threadRandom.generation = generation;
+	threadRandom.random.seed(seed);
+
+	return seed;
+}
+
+uint64_t Random::GetSeed()
+{
+	return GlobalSeed.load(std::memory_order_relaxed);
+}
+
+void Random::seed(uint64_t seed)
+{
+	// xoshiro must not start from an all zero state, splitmix never yields four zeros in a row
+	uint64_t state = seed;
+	for (uint64_t& word : _state)
+	{
+		word = SplitMix64(state);
+	}
+}
+
+#pragma region - Draws
+uint32_t Random::nextUInt32()
+{
+	// The high bits are the strongest ones
+	return static_cast<uint32_t>(nextUInt64() >> 32);
+}
+
+int Random::nextInt(int includedMin, int excludedMax)
+{
+	assert(includedMin < excludedMax);
+
+	// Lemire's multiply and shift, retrying the few values that would bias the result
+	const uint32_t range = static_cast<uint32_t>(static_cast<int64_t>(excludedMax) - includedMin);
+	uint64_t product = static_cast<uint64_t>(nextUInt32()) * range;
+	uint32_t low = static_cast<uint32_t>(product);
+	if (low < range)
+	{
+		const uint32_t threshold = (0u - range) % range;
+		while (low < threshold)
+		{
+			product = static_cast<uint64_t>(nextUInt32()) * range;
+			low = static_cast<uint32_t>(product);
+		}
+	}
+
+	return static_cast<int>(static_cast<int64_t>(includedMin) + static_cast<int64_t>(product >> 32));
+}
+
+float Random::nextFloat()
+{
+	return static_cast<float>(nextUInt64() >> 40) * RandomConstants::FloatUnit;
+}
+
+float Random::nextFloat(float includedMin, float excludedMax)
+{
+	return includedMin + (excludedMax - includedMin) * nextFloat();
+}
+
+void Random::fill(uint64_t* values, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		values[i] = nextUInt64();
+	}
+}
+
+void Random::fillInts(int* values, size_t count, int includedMin, int excludedMax)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		values[i] = nextInt(includedMin, excludedMax);
+	}
+}
+
+void Random::fillFloats(float* values, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		values[i] = nextFloat();
+	}
+}
+
+#pragma region - WeightedSampler
+WeightedSampler::WeightedSampler(const std::vector<float>& weights)
+{
+	setWeights(weights);
+}
+
+void WeightedSampler::setWeights(const std::vector<float>& weights)
+{
+	const size_t numOutcomes = weights.size();
+	assert(numOutcomes > 0);
+
+	double totalWeight = 0.0;
+	for (float weight : weights)
+	{
+		assert(weight >= 0.0f);
+		totalWeight += weight;
+	}
+	assert(totalWeight > 0.0);
+
+	_probabilities.assign(numOutcomes, 1.0f);
+	_aliases.resize(numOutcomes);
+
+	// Scaled so the average column holds exactly 1
+	std::vector<double> scaled(numOutcomes);
+	std::vector<uint32_t> small;
+	std::vector<uint32_t> large;
+	for (size_t i = 0; i < numOutcomes; ++i)
+	{
+		scaled[i] = weights[i] * numOutcomes / totalWeight;
+		_aliases[i] = static_cast<uint32_t>(i);
+		(scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+	}
+
+	// Every short column is topped up by a tall one, which shrinks by the same amount
+	while (!small.empty() && !large.empty())
+	{
+		const uint32_t shortColumn = small.back();
+		small.pop_back();
+		const uint32_t tallColumn = large.back();
+
+		_probabilities[shortColumn] = static_cast<float>(scaled[shortColumn]);
+		_aliases[shortColumn] = tallColumn;
+
+		scaled[tallColumn] -= 1.0 - scaled[shortColumn];
+		if (scaled[tallColumn] < 1.0)
+		{
+			large.pop_back();
+			small.push_back(tallColumn);
+		}
+	}
+
+	// Whatever is left is full up to rounding errors
+	for (uint32_t column : small)
+	{
+		_probabilities[column] = 1.0f;
+	}
+	for (uint32_t column : large)
+	{
+		_probabilities[column] = 1.0f;
+	}
+}
+
+size_t WeightedSampler::getNumOutcomes() const
+{
+	return _probabilities.size();
+}
+
+int WeightedSampler::sample(Random& random) const
+{
+	assert(!_probabilities.empty());
+
+	// One draw picks both the column, from the high half, and the coin, from the low 24 bits
+	const uint64_t value = random.nextUInt64();
+	const uint32_t column = static_cast<uint32_t>(((value >> 32) * _probabilities.size()) >> 32);
+	const float coin = static_cast<float>(value & 0xFFFFFF) * RandomConstants::FloatUnit;
+
+	return static_cast<int>(coin < _probabilities[column] ? column : _aliases[column]);
+}
+
+void WeightedSampler::sample(Random& random, int* values, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		values[i] = sample(random);
+	}
+}
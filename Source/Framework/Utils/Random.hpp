@@ -0,0 +1,95 @@
+//
+// Random.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Framework
+{
+	namespace Utils
+	{
+		//
+		// xoshiro256** generator, 32 bytes of state and a handful of instructions per draw. Every
+		// thread gets its own from Get(), so drawing needs no lock. The thread that calls SetSeed()
+		// gets the seed itself, any other thread a stream derived from the seed and the order in which
+		// it first drew, so game logic on the main thread replays exactly from the same seed
+		//
+		class Random final
+		{
+		public:
+			explicit Random(uint64_t seed);
+
+			// Generator of the calling thread
+			static Random& Get();
+
+			// Zero picks a seed from std::random_device. Returns the seed in use, for replays
+			static uint64_t SetSeed(uint64_t seed);
+			static uint64_t GetSeed();
+
+			void seed(uint64_t seed);
+
+			// Inline on purpose, every other draw is built on top of it
+			uint64_t nextUInt64()
+			{
+				const uint64_t result = RotateLeft(_state[1] * 5, 7) * 9;
+				const uint64_t t = _state[1] << 17;
+
+				_state[2] ^= _state[0];
+				_state[3] ^= _state[1];
+				_state[1] ^= _state[2];
+				_state[0] ^= _state[3];
+				_state[2] ^= t;
+				_state[3] = RotateLeft(_state[3], 45);
+
+				return result;
+			}
+
+			uint32_t nextUInt32();
+			// Uniform in [includedMin, excludedMax), without modulo bias
+			int nextInt(int includedMin, int excludedMax);
+			// Uniform in [0, 1)
+			float nextFloat();
+			float nextFloat(float includedMin, float excludedMax);
+
+			void fill(uint64_t* values, size_t count);
+			void fillInts(int* values, size_t count, int includedMin, int excludedMax);
+			void fillFloats(float* values, size_t count);
+
+		private:
+			static uint64_t RotateLeft(uint64_t value, int bits)
+			{
+				return (value << bits) | (value >> (64 - bits));
+			}
+
+			uint64_t _state[4];
+		};
+
+		//
+		// Draws indices with the probabilities given by a set of weights in constant time, using
+		// Vose's alias table. Building it is linear in the number of weights
+		//
+		class WeightedSampler final
+		{
+		public:
+			WeightedSampler() = default;
+			explicit WeightedSampler(const std::vector<float>& weights);
+
+			void setWeights(const std::vector<float>& weights);
+			size_t getNumOutcomes() const;
+
+			int sample(Random& random) const;
+			void sample(Random& random, int* values, size_t count) const;
+
+		private:
+			// Indexed by outcome: chance of keeping the column, and what it becomes otherwise
+			std::vector<float> _probabilities;
+			std::vector<uint32_t> _aliases;
+		};
+	}
+}
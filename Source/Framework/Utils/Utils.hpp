@@ -6,37 +6,29 @@
 
 #pragma once
 
-#include <random>
+#include <typeinfo>
+#include <typeindex>
+
+#include "Framework/Core/Types.hpp"
 
 namespace Framework
 {
     namespace Utils
     {
-        class RandomGenerator
-        {
-        public:
-            RandomGenerator(int includedMin, int excludedMax);
-            RandomGenerator(const std::vector<float>& weights);
-            ~RandomGenerator();
-
-            int getValue() const;
-
-        private:
-            class Generator;
-            class RangeGeneratorImpl;
-            class WeightedRangeGeneratorImpl;
-            std::unique_ptr<Generator> _generator;
-        };
+        // Ids are handed out in order of first use, they are only stable within a run
+        Types::ComponentId GetComponentIdFromType(const std::type_index& type);
 
         template<typename T>
-        const std::string GetComponentIdFromThis(const T& thiz)
+        Types::ComponentId GetComponentIdFromThis(const T& thiz)
         {
-            return typeid(thiz).name();
+            return GetComponentIdFromType(typeid(thiz));
         }
         template<typename T>
-        const std::string GetComponentIdFromClass()
+        Types::ComponentId GetComponentIdFromClass()
         {
-            return typeid(T).name();
+            // Resolved once per class, every later call is a plain load
+            static const Types::ComponentId componentId = GetComponentIdFromType(typeid(T));
+            return componentId;
         }
     }
 }
\ No newline at end of file
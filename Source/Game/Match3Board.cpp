@@ -42,6 +42,7 @@ namespace BoardConstants
 Game::Board::Board(const Size& size, IBoardListener* listener)
 	: _symbolsData(size)
 	, _cellsData(size)
+	, _model(size, Framework::Utils::Random::Get())
 	, _listener(listener)
 {
 	// Empty on purpose
@@ -68,10 +69,12 @@ void Game::Board::start()
 	_factory = CreateGameObject<Game::Factory>(getConfig());
 	_factory->setCurrentLevelNumber(0);
 
-	_randomGenerator = std::make_unique<Framework::Utils::RandomGenerator>(getSymbolsWeights());
+	_model.setSymbolWeights(getSymbolsWeights());
+	_model.setListener(this);
 
-	generateBoard();
-	findAndRemoveAllMatches();
+	// Symbols come in through onSymbolAdded()
+	generateCells(AllBoardPositions);
+	_model.generate();
 }
 
 void Game::Board::update(float dt)
@@ -101,7 +104,7 @@ void Game::Board::update(float dt)
 		{
 			setUserInteractionEnabled(false);
 
-			if (_lastMatches.empty())
+			if (!_model.hasMatches())
 			{
 				_state = State::WaitingUserInteraction;
 			}
@@ -111,8 +114,8 @@ void Game::Board::update(float dt)
 
 				_waitTimeForSymbolAnimation = BoardConstants::WaitTimeForSymbolAnimation;
 
-				notifyMatches(_lastMatches);
-				removeMatches(_lastMatches);
+				// Comes back through onSymbolsMatched()
+				_model.removeMatches();
 			}
 			break;
 		}
@@ -132,8 +135,8 @@ void Game::Board::update(float dt)
 		{
 			setUserInteractionEnabled(false);
 
-			generateEmptyPositions();
-			calculateExistingMatches();
+			// New symbols come back through onSymbolAdded()
+			_model.refill();
 
 			_isUserMatch = false;
 
@@ -165,12 +168,6 @@ void Game::Board::initConstants()
 }
 
 #pragma region - Board generation
-void Game::Board::generateBoard()
-{
-	generateCells(AllBoardPositions);
-	generateSymbols(AllBoardPositions);
-}
-
 std::vector<float> Game::Board::getSymbolsWeights() const
 {
 	std::vector<float> weights;
@@ -202,21 +199,6 @@ void Game::Board::addCell(Types::Cell::PtrType cell, const CellPosition& positio
 	_cellsData.at(position) = std::move(cell);
 }
 
-void Game::Board::generateSymbols(const CellPositions& specificPositions)
-{
-	for (const auto& cellPosition : specificPositions)
-	{
-		assert(_symbolsData.at(cellPosition) == nullptr);
-
-		int randomValue = _randomGenerator->getValue();
-
-		Symbol::Type pieceColor = static_cast<Symbol::Type>(randomValue);
-
-		Types::Symbol::PtrType symbol = _factory->createSymbol(pieceColor, cellPosition);
-		addSymbol(std::move(symbol), cellPosition);
-	}
-}
-
 void Game::Board::addSymbol(Types::Symbol::PtrType symbol, const CellPosition& position)
 {
 	addGameObject(symbol);
@@ -227,13 +209,6 @@ void Game::Board::addSymbol(Types::Symbol::PtrType symbol, const CellPosition& p
 	_symbolsData.at(position) = std::move(symbol);
 }
 
-void Game::Board::generateEmptyPositions()
-{
-	CellPositions emptyPositions = getEmptyCellPositions();
-	assert(!emptyPositions.empty());
-	generateSymbols(emptyPositions);
-}
-
 #pragma region - User interaction
 void Game::Board::onUserSelectedSymbol(Types::Symbol::PtrType selectedSymbol, bool isDragDrop)
 {
@@ -337,92 +312,47 @@ void Game::Board::stopSymbolPossibleMoveAnimation(const CellPosition& cellPositi
 }
 
 #pragma region - Matches handling
-void Game::Board::findAndRemoveAllMatches()
-{
-	Matches matches = findAllMatches();
-	while (!matches.empty())
-	{
-		removeMatches(matches);
-		generateSymbols(matches);
-		matches = findAllMatches();
-	};
-}
-
-void Game::Board::calculateExistingMatches()
-{
-	_lastMatches = findAllMatches();
-}
-
-Game::Board::Matches Game::Board::calculatePossibleMatches(Types::Symbol::PtrType selectedSymbol, Types::Symbol::PtrType toSymbol)
-{
-	Matches matches;
-
-	matches.merge(findMatchesForPosition(selectedSymbol->getCellPosition()));
-	matches.merge(findMatchesForPosition(toSymbol->getCellPosition()));
-
-	return matches;
-}
-
 void Game::Board::resolvePossibleMatches(Types::Symbol::PtrType selectedSymbol, const CellPosition& toPosition)
 {
-	if (!isPositionInsideBoard(toPosition) ||
-		!isValidMove(selectedSymbol, toPosition))
+	// A kept swap comes back through onSymbolsSwapped()
+	if (!_model.trySwap(selectedSymbol->getCellPosition(), toPosition))
 	{
-		// Valid case, user clicked outside the board
-		_state = State::WaitingUserInteraction;
-
+		// Valid case, user clicked outside the board or the move makes no match. A dragged symbol
+		// goes back to its cell
 		swapSymbols(*selectedSymbol, *selectedSymbol);
-		return;
-	}
-
-	Types::Symbol::PtrType toSymbol = _symbolsData.at(toPosition);
-	assert(toSymbol);
-
-	swapSymbols(*selectedSymbol, *toSymbol);
-
-	_lastMatches = calculatePossibleMatches(selectedSymbol, toSymbol);
-	if (_lastMatches.empty())
-	{
-		swapSymbols(*selectedSymbol, *toSymbol);
 	}
 
 	_state = State::CheckMatches;
 }
 
-bool Game::Board::isValidMove(Types::Symbol::PtrType selectedSymbol, const CellPosition& toPosition) const
-{
-	using namespace BoardConstants;
-
-	const CellPosition& cellPosition = selectedSymbol->getCellPosition();
-
-	return (toPosition == cellPosition + UpDirection ||
-		toPosition == cellPosition + DownDirection ||
-		toPosition == cellPosition + LeftDirection ||
-		toPosition == cellPosition + RightDirection);
-}
-
 void Game::Board::notifyMatches(const Matches& matches)
 {
 	IBoardListener::MatchedSymbols symbols;
-	std::transform(matches.rbegin(), matches.rend(), std::back_inserter(symbols), [this](const CellPosition& cellPosition) -> Types::Symbol::PtrType
+	symbols.reserve(matches.count());
+	matches.forEach([this, &symbols](const CellPosition& cellPosition)
 	{
-		return _symbolsData.at(cellPosition);
+		symbols.push_back(_symbolsData.at(cellPosition));
 	});
 	_listener->onSymbolsMatched(_isUserMatch, symbols);
 }
 
 void Game::Board::removeMatches(const Matches& matches)
 {
-	for (const auto& match : matches)
+	matches.forEach([this](const CellPosition& cellPosition)
 	{
-		removeSymbolAtCellPosition(match);
-	}
+		removeSymbolAtCellPosition(cellPosition);
+	});
+}
+
+void Game::Board::recycleSymbol(Types::Symbol::PtrType symbol)
+{
+	_factory->releaseSymbol(std::move(symbol));
 }
 
 void Game::Board::removeSymbolAtCellPosition(const CellPosition& cellPosition)
 {
 	Types::Symbol::PtrType symbol = _symbolsData.at(cellPosition);
-	_symbolsData.at(cellPosition).reset();
+	_symbolsData.at(cellPosition) = nullptr;
 	removeGameObject(symbol->getInstanceId());
 }
 
@@ -440,102 +370,40 @@ void Game::Board::swapSymbols(Symbol& symbolA, Symbol& symbolB)
 	symbolA.setCellPosition(newCellPosition);
 	symbolB.setCellPosition(originalCellPosition);
 
-	auto tmp = _symbolsData.at(originalCellPosition);
-	_symbolsData.at(originalCellPosition) = _symbolsData.at(newCellPosition);
-	_symbolsData.at(newCellPosition) = tmp;
+	std::swap(_symbolsData.at(originalCellPosition), _symbolsData.at(newCellPosition));
 }
 
-Game::Board::Matches Game::Board::findAllMatches()
+#pragma region - Model events
+void Game::Board::onSymbolAdded(const CellPosition& position, Types::Symbol::Type type)
 {
-	Matches retValue;
-
-	iterateBoardCells([this, &retValue](const CellPosition& cellPosition)
-	{
-		retValue.merge(findMatchesForPosition(cellPosition));
-	});
-	return retValue;
+	Types::Symbol::PtrType symbol = _factory->createSymbol(type, position);
+	addSymbol(std::move(symbol), position);
 }
 
-Game::Board::Matches Game::Board::findMatchesForPosition(const CellPosition& position)
+void Game::Board::onSymbolsSwapped(const CellPosition& a, const CellPosition& b)
 {
-	Matches retValue;
-
-	retValue.merge(findHorizontalMatches(position));
-	retValue.merge(findVerticalMatches(position));
-
-	return retValue;
+	swapSymbols(*_symbolsData.at(a), *_symbolsData.at(b));
 }
 
-Game::Board::Matches Game::Board::findHorizontalMatches(const CellPosition& position)
+void Game::Board::onSymbolsMatched(const Matches& matches)
 {
-	using namespace BoardConstants;
-
-	Matches retValue;
-
-	retValue.merge(findMatchesForDirection(position, LeftDirection));
-	retValue.merge(findMatchesForDirection(position, RightDirection));
-
-	if (retValue.size() < Match3::Game::Globals::MinNumberMatches)
-	{
-		retValue.clear();
-	}
-
-	return retValue;
+	notifyMatches(matches);
+	removeMatches(matches);
 }
 
-Game::Board::Matches Game::Board::findVerticalMatches(const CellPosition& position)
+void Game::Board::onSymbolDropped(const CellPosition& from, const CellPosition& to)
 {
-	using namespace BoardConstants;
-
-	Matches retValue;
-
-	retValue.merge(findMatchesForDirection(position, UpDirection));
-	retValue.merge(findMatchesForDirection(position, DownDirection));
-
-	if (retValue.size() < Match3::Game::Globals::MinNumberMatches)
-	{
-		retValue.clear();
-	}
-
-	return retValue;
+	addDropAnimation(_symbolsData.at(from), to);
 }
 
-Game::Board::Matches Game::Board::findMatchesForDirection(const CellPosition& originalPos, const Direction& direction)
-{
-	Matches retValue;
-
-	auto symbolPtr = _symbolsData.at(originalPos);
-
-	CellPosition currentPos = originalPos + direction;
-	while (currentPos.x >= 0 && currentPos.x < _symbolsData.getSize().width &&
-		currentPos.y >= 0 && currentPos.y < _symbolsData.getSize().height)
-	{
-		auto otherSymbolPtr = _symbolsData.at(currentPos);
-
-		if (otherSymbolPtr && symbolPtr->getType() != otherSymbolPtr->getType())
-		{
-			break;
-		}
-
-		if (retValue.empty())
-		{
-			retValue.insert(originalPos);
-		}
-		retValue.insert(currentPos);
-
-		currentPos += direction;
-	}
-	return retValue;
-}
-
-
 #pragma region - Animations
 void Game::Board::updateMatchedSymbols(float dt)
 {
 	_waitTimeForSymbolAnimation -= dt;
 	if (_waitTimeForSymbolAnimation <= 0)
 	{
-		if (prepareDroppingSymbols())
+		// Falling symbols come back through onSymbolDropped()
+		if (_model.applyGravity() > 0)
 		{
 			_state = State::DroppingSymbols;
 		}
@@ -546,41 +414,6 @@ void Game::Board::updateMatchedSymbols(float dt)
 	}
 }
 
-bool Game::Board::prepareDroppingSymbols()
-{
-	using namespace BoardConstants;
-
-	bool isAtLeastOneAnimation = false;
-
-	for (int column = 0; column < _symbolsData.getSize().width; ++column)
-	{
-		int gap = 0;
-
-		for (int row = _symbolsData.getSize().height - 1; row >= 0; --row)
-		{
-			CellPosition cellPosition(column, row);
-
-			Types::Symbol::PtrType symbol = _symbolsData.at(cellPosition);
-			if (symbol)
-			{
-				if (gap > 0)
-				{
-					CellPosition targetPosition = cellPosition + gap * DownDirection;
-					addDropAnimation(symbol, targetPosition);
-
-					isAtLeastOneAnimation = true;
-				}
-			}
-			else
-			{
-				++gap;
-			}
-		}
-	}
-
-	return isAtLeastOneAnimation;
-}
-
 void Game::Board::addDropAnimation(Types::Symbol::PtrType symbol, const CellPosition& targetCell)
 {
 	using BounceUpDownAnimation = Framework::Components::BounceUpDownAnimation;
@@ -609,15 +442,16 @@ void Game::Board::addDropAnimation(Types::Symbol::PtrType symbol, const CellPosi
 	symbol->setState(Symbol::State::Dropping);
 
 	_finalSymbolPositions.emplace_back(FinalPosition{ symbol, targetCell });
-	_symbolsData.at(startCell).reset();
+	_symbolsData.at(startCell) = nullptr;
 
 	++_numFallingSymbols;
 }
 
 void Game::Board::onDropAnimationFinished(Framework::Components::BounceUpDownAnimation& bounceAnimation)
 {
-	// TODO: this crashes, haven't discovered why
-	// bounceAnimation.getOwner().removeComponent(bounceAnimation);
+	// Called from AnimationSystem::update, after the sync point, so the removal destroys the
+	// animation right away. Nothing may touch bounceAnimation past this line
+	bounceAnimation.getOwner().removeComponent(bounceAnimation);
 
 	if (--_numFallingSymbols == 0)
 	{
@@ -688,77 +522,6 @@ void Game::Board::iterateBoardCells(const BoardIteratorFunc& func)
 	}
 }
 
-Game::Board::CellPositions Game::Board::getEmptyCellPositions() const
-{
-	CellPositions emptyPositions;
-
-	iterateBoardCells([this, &emptyPositions](const CellPosition& cellPosition)
-	{
-		Types::Symbol::PtrType symbol = _symbolsData.at(cellPosition);
-		if (symbol == nullptr)
-		{
-			emptyPositions.insert(cellPosition);
-		}
-	});
-
-	return emptyPositions;
-}
-
-
-int Game::Board::getNumberGapsFromCellPosition(const Direction& direction, const CellPosition& fromPosition) const
-{
-	int gap = 1; // The fromPosition should be empty
-	CellPosition position = fromPosition;
-
-	position += direction;
-	while (isPositionInsideBoard(position))
-	{
-		Types::Symbol::PtrType symbol = _symbolsData.at(position);
-		if (symbol)
-		{
-			break;
-		}
-
-		++gap;
-		position += direction;
-	}
-
-	return gap;
-}
-
-std::vector<Types::Symbol::PtrType> Game::Board::getAllSymbolsInDirection(const Direction& direction, const CellPosition& fromPosition)
-{
-	std::vector<Types::Symbol::PtrType> foundSymbols;
-	CellPosition position = fromPosition;
-
-	position += direction;
-	while (isPositionInsideBoard(position))
-	{
-		Types::Symbol::PtrType symbol = _symbolsData.at(position);
-		if (symbol)
-		{
-			foundSymbols.push_back(std::move(symbol));
-			_symbolsData.at(position) = nullptr;
-		}
-		position += direction;
-	}
-
-	return foundSymbols;
-}
-
-Types::Symbol::PtrType Game::Board::getSymbolInDirection(const Direction& direction, const CellPosition& fromPosition)
-{
-	CellPosition position = fromPosition + direction;
-	if (isPositionInsideBoard(position))
-	{
-		return _symbolsData.at(position);
-	}
-	else
-	{
-		return nullptr;
-	}
-}
-
 void Game::Board::setUserInteractionEnabled(bool enabled)
 {
 	_isUserInteractionEnabled = enabled;
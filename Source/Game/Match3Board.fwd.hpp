@@ -18,6 +18,7 @@ namespace Match3
 	namespace Game
 	{
 		class Board;
+		class CellMask;
 	}
 	namespace Types
 	{
@@ -28,13 +29,13 @@ namespace Match3
 			using Position = glm::ivec2;
 
 			struct CompareCellPosition {
-				bool operator()(const Position& a, const Position& b) {
+				bool operator()(const Position& a, const Position& b) const {
 					return (a.x * Game::Globals::MaxBoardSize + a.y) <
 						(b.x * Game::Globals::MaxBoardSize + b.y);
 				}
 			};
 			using CellPositions = std::set<Position, CompareCellPosition>;
-			using Matches = CellPositions;
+			using Matches = Match3::Game::CellMask;
 		};
 	}
 }
\ No newline at end of file
@@ -11,12 +11,14 @@
 #include "Framework/Core/Types.hpp"
 #include "Framework/Core/GameObject.hpp"
 #include "Framework/Utils/Utils.hpp"
+#include "Framework/Utils/Random.hpp"
 
 #include "Match3Symbol.fwd.hpp"
 #include "Match3Cell.fwd.hpp"
 #include "Match3Factory.fwd.hpp"
 #include "Match3Globals.hpp"
 #include "Match3Utils.hpp"
+#include "Match3BoardModel.hpp"
 
 namespace Match3
 {
@@ -33,7 +35,11 @@ namespace Match3
 
 #pragma region - Board
 		struct Config;
-		class Board final : public Framework::Core::GameObject
+		//
+		// View of a BoardModel. The model decides, the board turns what it reports into symbols,
+		// animations and user interaction
+		//
+		class Board final : public Framework::Core::GameObject, public IBoardModelListener
 		{
 		public:
 			using Size = Framework::Types::Size;
@@ -62,6 +68,9 @@ namespace Match3
 
 			bool isUserInteractionEnabled() const;
 
+			// Matched symbols come back here once they are done flying
+			void recycleSymbol(Types::Symbol::PtrType symbol);
+
 		protected:
 #pragma region - User interaction
 			friend class MouseHandling;
@@ -85,17 +94,11 @@ namespace Match3
 
 #pragma region - Board generation
 			std::vector<float> getSymbolsWeights() const;
-			void generateBoard();
 			void generateCells(const CellPositions& specificPositions);
 			void addCell(Types::Cell::PtrType cell, const CellPosition& position);
-			void generateSymbols(const CellPositions& specificPositions);
 			void addSymbol(Types::Symbol::PtrType symbol, const CellPosition& position);
-			void generateEmptyPositions();
 
 #pragma region - Match finding
-			void calculateExistingMatches();
-			void findAndRemoveAllMatches();
-			Matches calculatePossibleMatches(Types::Symbol::PtrType selectedSymbol, Types::Symbol::PtrType toSymbol);
 			void resolvePossibleMatches(Types::Symbol::PtrType selectedSymbol, const CellPosition& cellPosition);
 			void notifyMatches(const Matches& matches);
 
@@ -103,15 +106,14 @@ namespace Match3
 			void removeSymbolAtCellPosition(const CellPosition& cellPosition);
 			void swapSymbols(Symbol& _selectedSymbol, Symbol& symbol);
 
-			Matches findAllMatches();
-			Matches findMatchesForPosition(const CellPosition& position);
-			Matches findHorizontalMatches(const CellPosition& position);
-			Matches findVerticalMatches(const CellPosition& position);
-			Matches findMatchesForDirection(const CellPosition& position, const Direction& direction);
+#pragma region - Model events
+			void onSymbolAdded(const CellPosition& position, Types::Symbol::Type type) override;
+			void onSymbolsSwapped(const CellPosition& a, const CellPosition& b) override;
+			void onSymbolsMatched(const Matches& matches) override;
+			void onSymbolDropped(const CellPosition& from, const CellPosition& to) override;
 
 #pragma region - Animations
 			void updateMatchedSymbols(float dt);
-			bool prepareDroppingSymbols();
 			void addDropAnimation(Types::Symbol::PtrType symbol, const CellPosition& targetCell);
 
 			void onDropAnimationFinished(Framework::Components::BounceUpDownAnimation& bounceAnimation);
@@ -120,11 +122,6 @@ namespace Match3
 			using BoardIteratorFunc = std::function<void(const CellPosition& cell)>;
 			void iterateBoardCells(const BoardIteratorFunc& func);
 			void iterateBoardCells(const BoardIteratorFunc& func) const;
-			bool isValidMove(Types::Symbol::PtrType selectedSymbol, const CellPosition& toPosition) const;
-			std::vector<Types::Symbol::PtrType> getAllSymbolsInDirection(const Direction& direction, const CellPosition& fromPosition);
-			Types::Symbol::PtrType getSymbolInDirection(const Direction& direction, const CellPosition& fromPosition);
-			int getNumberGapsFromCellPosition(const Direction& direction, const CellPosition& fromPosition) const;
-			CellPositions getEmptyCellPositions() const;
 			void setUserInteractionEnabled(bool enabled);
 
 #pragma region - Data
@@ -150,8 +147,8 @@ namespace Match3
 
 			BoardData _symbolsData;
 			CellsData _cellsData;
+			BoardModel _model;
 
-			std::unique_ptr<Framework::Utils::RandomGenerator> _randomGenerator;
 			IBoardListener* _listener = nullptr;
 
 #pragma region - Board regeneration data
@@ -170,7 +167,6 @@ namespace Match3
 				Point2D targetPosition;
 			};
 
-			Matches _lastMatches;
 			std::vector<DropAnimationItem> _droppingSymbolsAnimation;
 			float _waitTimeForSymbolAnimation = 0.0f;
 			int _numFallingSymbols = 0;
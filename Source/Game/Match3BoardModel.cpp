@@ -0,0 +1,387 @@
+//
+// Match3BoardModel.cpp
+//
+// @author Roberto Cano
+//
+
+#include "Match3BoardModel.hpp"
+
+#include <cassert>
+
+using namespace Match3;
+using namespace Match3::Game;
+
+namespace BoardModelConstants
+{
+	const int BorderSize = 1;
+}
+
+BoardModel::BoardModel(const Size& size, Framework::Utils::Random& random)
+	: _size(size)
+	, _stride(size.width + 2 * BoardModelConstants::BorderSize)
+	, _types(_stride * (size.height + 2 * BoardModelConstants::BorderSize), BorderType)
+	, _matchFinder(size)
+	, _matches(size)
+	, _random(&random)
+{
+	for (int row = 0; row < size.height; ++row)
+	{
+		for (int column = 0; column < size.width; ++column)
+		{
+			_types[getIndex(Position(column, row))] = EmptyType;
+		}
+	}
+}
+
+void BoardModel::setListener(IBoardModelListener* listener)
+{
+	_listener = listener;
+}
+
+void BoardModel::setSymbolWeights(const std::vector<float>& weights)
+{
+	assert(weights.size() == static_cast<size_t>(SymbolType::_end));
+	_symbolSampler.setWeights(weights);
+}
+
+const BoardModel::Size& BoardModel::getSize() const
+{
+	return _size;
+}
+
+bool BoardModel::isInside(const Position& position) const
+{
+	return position.x >= 0 && position.x < _size.width &&
+		position.y >= 0 && position.y < _size.height;
+}
+
+bool BoardModel::isEmpty(const Position& position) const
+{
+	return _types[getIndex(position)] == EmptyType;
+}
+
+BoardModel::SymbolType BoardModel::getSymbolType(const Position& position) const
+{
+	const uint8_t type = _types[getIndex(position)];
+	return type == EmptyType ? SymbolType::_end : static_cast<SymbolType>(type);
+}
+
+#pragma region - Steps
+void BoardModel::generate()
+{
+	for (int row = 0; row < _size.height; ++row)
+	{
+		for (int column = 0; column < _size.width; ++column)
+		{
+			setType(getIndex(Position(column, row)), sampleType());
+		}
+	}
+
+	// Matches are rerolled quietly, the listener only gets the final board
+	for (CellMask matches = findNewMatches(); !matches.isEmpty(); matches = findNewMatches())
+	{
+		matches.forEach([this](const Position& position)
+		{
+			setType(getIndex(position), sampleType());
+		});
+	}
+	_matches.clear();
+
+	if (_listener != nullptr)
+	{
+		for (int row = 0; row < _size.height; ++row)
+		{
+			for (int column = 0; column < _size.width; ++column)
+			{
+				const Position position(column, row);
+				_listener->onSymbolAdded(position, getSymbolType(position));
+			}
+		}
+	}
+}
+
+bool BoardModel::isValidSwap(const Position& a, const Position& b) const
+{
+	const Position delta = b - a;
+	return isInside(a) && isInside(b) && glm::abs(delta.x) + glm::abs(delta.y) == 1 &&
+		!isEmpty(a) && !isEmpty(b);
+}
+
+bool BoardModel::trySwap(const Position& a, const Position& b)
+{
+	if (!isValidSwap(a, b))
+	{
+		return false;
+	}
+
+	swapTypes(getIndex(a), getIndex(b));
+
+	_matches = findNewMatches();
+	if (_matches.isEmpty())
+	{
+		// Back to a board already known to hold no matches
+		swapTypes(getIndex(a), getIndex(b));
+		_matchFinder.clearDirtyRegion();
+		return false;
+	}
+
+	if (_listener != nullptr)
+	{
+		_listener->onSymbolsSwapped(a, b);
+	}
+	return true;
+}
+
+void BoardModel::findPossibleMoves(Moves& moves) const
+{
+	moves.clear();
+
+	const Index rightStep = 1;
+	const Index downStep = _stride;
+
+	for (int row = 0; row < _size.height; ++row)
+	{
+		for (int column = 0; column < _size.width; ++column)
+		{
+			const Position position(column, row);
+			const Index index = getIndex(position);
+
+			// The border never makes a move, so the last column and row need no special case
+			if (isPossibleMove(index, index + rightStep))
+			{
+				moves.push_back(Move{ position, position + Position(1, 0) });
+			}
+			if (isPossibleMove(index, index + downStep))
+			{
+				moves.push_back(Move{ position, position + Position(0, 1) });
+			}
+		}
+	}
+}
+
+bool BoardModel::hasPossibleMoves() const
+{
+	const Index rightStep = 1;
+	const Index downStep = _stride;
+
+	for (int row = 0; row < _size.height; ++row)
+	{
+		for (Index index = getIndex(Position(0, row)); _types[index] != BorderType; ++index)
+		{
+			if (isPossibleMove(index, index + rightStep) || isPossibleMove(index, index + downStep))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool BoardModel::hasMatches() const
+{
+	return !_matches.isEmpty();
+}
+
+const CellMask& BoardModel::getMatches() const
+{
+	return _matches;
+}
+
+int BoardModel::removeMatches()
+{
+	const int numRemoved = _matches.count();
+	if (numRemoved == 0)
+	{
+		return 0;
+	}
+
+	// Reported first, so the listener still sees what is being removed
+	if (_listener != nullptr)
+	{
+		_listener->onSymbolsMatched(_matches);
+	}
+
+	_matches.forEach([this](const Position& position)
+	{
+		setType(getIndex(position), EmptyType);
+	});
+	_matches.clear();
+
+	return numRemoved;
+}
+
+int BoardModel::applyGravity()
+{
+	const Index upStep = -_stride;
+	int numMoved = 0;
+
+	for (int column = 0; column < _size.width; ++column)
+	{
+		// Bottom up until the border on top, every symbol falls as many cells as it has gaps below
+		int gap = 0;
+		for (Index index = getIndex(Position(column, _size.height - 1)); _types[index] != BorderType; index += upStep)
+		{
+			if (_types[index] == EmptyType)
+			{
+				++gap;
+			}
+			else if (gap > 0)
+			{
+				const Index targetIndex = index - gap * upStep;
+				setType(targetIndex, _types[index]);
+				setType(index, EmptyType);
+				++numMoved;
+
+				if (_listener != nullptr)
+				{
+					_listener->onSymbolDropped(getPosition(index), getPosition(targetIndex));
+				}
+			}
+		}
+	}
+
+	return numMoved;
+}
+
+int BoardModel::refill()
+{
+	int numAdded = 0;
+
+	for (int row = 0; row < _size.height; ++row)
+	{
+		for (int column = 0; column < _size.width; ++column)
+		{
+			const Position position(column, row);
+			const Index index = getIndex(position);
+			if (_types[index] != EmptyType)
+			{
+				continue;
+			}
+
+			const uint8_t type = sampleType();
+			setType(index, type);
+			++numAdded;
+
+			if (_listener != nullptr)
+			{
+				_listener->onSymbolAdded(position, static_cast<SymbolType>(type));
+			}
+		}
+	}
+
+	// Only the fallen and new symbols can make matches
+	_matches = findNewMatches();
+
+	return numAdded;
+}
+
+int BoardModel::resolveCascade()
+{
+	int numRemoved = 0;
+	while (hasMatches())
+	{
+		numRemoved += removeMatches();
+		applyGravity();
+		refill();
+	}
+	return numRemoved;
+}
+
+#pragma region - Helpers
+BoardModel::Index BoardModel::getIndex(const Position& position) const
+{
+	using namespace BoardModelConstants;
+
+	assert(position.x >= -BorderSize && position.x < _size.width + BorderSize);
+	assert(position.y >= -BorderSize && position.y < _size.height + BorderSize);
+	return (position.y + BorderSize) * _stride + position.x + BorderSize;
+}
+
+BoardModel::Position BoardModel::getPosition(Index index) const
+{
+	using namespace BoardModelConstants;
+
+	return Position(index % _stride - BorderSize, index / _stride - BorderSize);
+}
+
+void BoardModel::setType(Index index, uint8_t type)
+{
+	assert(_types[index] != BorderType);
+
+	_types[index] = type;
+
+	const Position position = getPosition(index);
+	if (type == EmptyType)
+	{
+		_matchFinder.clearSymbol(position);
+	}
+	else
+	{
+		_matchFinder.setSymbol(position, static_cast<SymbolType>(type));
+	}
+}
+
+void BoardModel::swapTypes(Index a, Index b)
+{
+	const uint8_t typeA = _types[a];
+	setType(a, _types[b]);
+	setType(b, typeA);
+}
+
+uint8_t BoardModel::sampleType()
+{
+	return static_cast<uint8_t>(_symbolSampler.sample(*_random));
+}
+
+bool BoardModel::isPossibleMove(Index a, Index b) const
+{
+	const uint8_t typeA = _types[a];
+	const uint8_t typeB = _types[b];
+	const uint8_t numTypes = static_cast<uint8_t>(SymbolType::_end);
+
+	// Border and empty cells are above every symbol type
+	if (typeA >= numTypes || typeB >= numTypes || typeA == typeB)
+	{
+		return false;
+	}
+
+	// Once swapped, each cell holds the type of the other one
+	return wouldMatchAt(b, typeA, a) || wouldMatchAt(a, typeB, b);
+}
+
+bool BoardModel::wouldMatchAt(Index index, uint8_t type, Index ignoredIndex) const
+{
+	const int minRun = Globals::MinNumberMatches;
+
+	const int horizontal = 1 + countRun(index, -1, type, ignoredIndex) + countRun(index, 1, type, ignoredIndex);
+	if (horizontal >= minRun)
+	{
+		return true;
+	}
+
+	const int vertical = 1 + countRun(index, -_stride, type, ignoredIndex) + countRun(index, _stride, type, ignoredIndex);
+	return vertical >= minRun;
+}
+
+int BoardModel::countRun(Index index, Index step, uint8_t type, Index ignoredIndex) const
+{
+	// Stops on the border at the latest, it never holds a symbol type
+	int count = 0;
+	for (Index next = index + step; next != ignoredIndex && _types[next] == type; next += step)
+	{
+		++count;
+	}
+	return count;
+}
+
+CellMask BoardModel::findNewMatches()
+{
+	CellMask matches = _matchFinder.findMatchesInDirtyRegion();
+
+	// Debug builds cross-check against a full scan. A difference means the board was changed
+	// behind setType() or a match was left on it
+	assert(matches == _matchFinder.findAllMatches());
+
+	_matchFinder.clearDirtyRegion();
+	return matches;
+}
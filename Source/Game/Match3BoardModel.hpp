@@ -0,0 +1,131 @@
+//
+// Match3BoardModel.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Framework/Core/Types.hpp"
+#include "Framework/Utils/Random.hpp"
+
+#include "Match3Board.fwd.hpp"
+#include "Match3Symbol.fwd.hpp"
+#include "Match3MatchFinder.hpp"
+
+namespace Match3
+{
+	namespace Game
+	{
+#pragma region - BoardModelListener
+		class IBoardModelListener
+		{
+		public:
+			using Position = Types::Board::Position;
+			using SymbolType = Types::Symbol::Type;
+
+			virtual void onSymbolAdded(const Position& position, SymbolType type) = 0;
+			virtual void onSymbolsSwapped(const Position& a, const Position& b) = 0;
+			virtual void onSymbolsMatched(const CellMask& matches) = 0;
+			virtual void onSymbolDropped(const Position& from, const Position& to) = 0;
+		};
+
+#pragma region - BoardModel
+		//
+		// The rules of the board on plain data: what is where, which swaps are allowed, what
+		// matches, how symbols fall and what comes in to refill. Nothing here knows about game
+		// objects or time, every step runs to completion and reports what it did to the listener,
+		// if any, so the same model drives the visual board and headless simulations.
+		//
+		// A turn goes trySwap(), then removeMatches(), applyGravity() and refill() for as long as
+		// hasMatches(), which resolveCascade() does in one call
+		//
+		class BoardModel final
+		{
+		public:
+			using Size = Framework::Types::Size;
+			using Position = Types::Board::Position;
+			using SymbolType = Types::Symbol::Type;
+
+			struct Move
+			{
+				Position from;
+				Position to;
+			};
+			using Moves = std::vector<Move>;
+
+			BoardModel(const Size& size, Framework::Utils::Random& random);
+
+			void setListener(IBoardModelListener* listener);
+			void setSymbolWeights(const std::vector<float>& weights);
+
+			const Size& getSize() const;
+			bool isInside(const Position& position) const;
+			bool isEmpty(const Position& position) const;
+			// _end for empty cells
+			SymbolType getSymbolType(const Position& position) const;
+
+			// Fills the whole board without matches, then reports every symbol
+			void generate();
+
+			// Inside the board and next to each other
+			bool isValidSwap(const Position& a, const Position& b) const;
+			// Keeps the swap only when it makes a match, the board is left untouched otherwise
+			bool trySwap(const Position& a, const Position& b);
+
+			// Every swap that trySwap() would keep, each pair once and pointing right or down. Works
+			// on the board as it is, nothing is changed or reported
+			void findPossibleMoves(Moves& moves) const;
+			// Stops at the first one, a board without any is dead
+			bool hasPossibleMoves() const;
+
+			bool hasMatches() const;
+			const CellMask& getMatches() const;
+
+			// Each returns how many symbols it removed, moved or added
+			int removeMatches();
+			int applyGravity();
+			int refill();
+
+			// Steps until no match is left, returns the number of symbols removed
+			int resolveCascade();
+
+		private:
+			using Index = int;
+
+			static constexpr uint8_t EmptyType = 0xFF;
+			static constexpr uint8_t BorderType = 0xFE;
+
+			Index getIndex(const Position& position) const;
+			Position getPosition(Index index) const;
+
+			void setType(Index index, uint8_t type);
+			void swapTypes(Index a, Index b);
+			uint8_t sampleType();
+
+			CellMask findNewMatches();
+
+			// Whether a symbol of the given type at index would be part of a run, with the cell at
+			// ignoredIndex taken as holding something else
+			bool wouldMatchAt(Index index, uint8_t type, Index ignoredIndex) const;
+			int countRun(Index index, Index step, uint8_t type, Index ignoredIndex) const;
+			bool isPossibleMove(Index a, Index b) const;
+
+			Size _size;
+			int _stride = 0;
+
+			// Row major with a one cell border of BorderType around the board, walks stop on it
+			std::vector<uint8_t> _types;
+
+			MatchFinder _matchFinder;
+			CellMask _matches;
+
+			Framework::Utils::Random* _random = nullptr;
+			Framework::Utils::WeightedSampler _symbolSampler;
+			IBoardModelListener* _listener = nullptr;
+		};
+	}
+}
@@ -11,6 +11,7 @@
 #include "Framework/Components/SpriteRenderer.hpp"
 #include "Framework/Components/MouseHandler.hpp"
 #include "Framework/Components/SoundEmitter.hpp"
+#include "Framework/Utils/EnumIterator.hpp"
 
 #include "Match3Utils.hpp"
 #include "Match3Board.hpp"
@@ -35,7 +36,14 @@ namespace FactoryConstants
 Factory::Factory(const Config& config)
 	: _config(config)
 {
-	// Empty on purpose
+	for (EnumBEIterator<SymbolType> iter; iter; iter++)
+	{
+		const SymbolType symbolType = *iter;
+		_symbolPools.emplace_back([this, symbolType]()
+		{
+			return buildSymbol(symbolType);
+		});
+	}
 }
 
 void Factory::setCurrentLevelNumber(int level)
@@ -75,7 +83,25 @@ Framework::Types::GameObject::PtrType Factory::createBackground(const std::strin
 	return gameObject;
 }
 
-Types::Symbol::PtrType Factory::createSymbol(SymbolType symbolColor, const Types::Cell::Position& cellPosition)
+Types::Symbol::PtrType Factory::createSymbol(SymbolType symbolColor, const Types::Cell::Position& /* cellPosition */)
+{
+	return getSymbolPool(symbolColor).acquire();
+}
+
+void Factory::releaseSymbol(Types::Symbol::PtrType symbol)
+{
+	const SymbolType symbolType = symbol->getType();
+	getSymbolPool(symbolType).release(std::move(symbol));
+}
+
+Factory::SymbolPool& Factory::getSymbolPool(SymbolType type)
+{
+	const size_t poolIndex = static_cast<size_t>(type) - static_cast<size_t>(SymbolType::_begin);
+	assert(poolIndex < _symbolPools.size());
+	return _symbolPools[poolIndex];
+}
+
+Types::Symbol::PtrType Factory::buildSymbol(SymbolType symbolColor)
 {
 	using namespace Framework::Components;
 	using namespace Framework::Types;
@@ -85,7 +111,6 @@ Types::Symbol::PtrType Factory::createSymbol(SymbolType symbolColor, const Types
 	const Size& symbolSize = _config.cellSizeInPixels;
 	std::shared_ptr<Symbol> symbol = CreateGameObject<Symbol>(symbolColor, symbolSize);
 	assert(symbol);
-	symbol->setState(Symbol::State::Appearing);
 
 	// Shadow sprite renderer
 	const std::string& shadowAssetPath = getAssetPathForShadowType(symbolColor);
@@ -10,6 +10,7 @@
 
 #include "Framework/Core/Types.hpp"
 #include "Framework/Core/GameObject.hpp"
+#include "Framework/Core/GameObjectPool.hpp"
 
 #include "Match3Board.hpp"
 #include "Match3Symbol.fwd.hpp"
@@ -39,13 +40,19 @@ namespace Match3
 
 			Framework::Types::GameObject::PtrType Factory::createBackground(const std::string& assetPath, const Point2D& position);
 			Types::Cell::PtrType createBoardCell(const Types::Cell::Position& cellPosition);
+			// Symbols are recycled, hand them back once they leave the game
 			Types::Symbol::PtrType createSymbol(SymbolType symbolColor, const Types::Cell::Position& cellPosition);
+			void releaseSymbol(Types::Symbol::PtrType symbol);
 			Types::Board::PtrType createBoard(IBoardListener* listener);
 			Framework::Types::GameObject::PtrType createSoundObject(const std::string& visualDescription);
 			Types::ScoreRenderer::PtrType createScoreRenderer(const std::string& prefix, bool isSoundEnabled);
 
 		private:
+			using SymbolPool = Framework::Core::GameObjectPool<Symbol>;
+
 			const Config::BoardLevel& getCurrentLevel() const;
+			SymbolPool& getSymbolPool(SymbolType type);
+			Types::Symbol::PtrType buildSymbol(SymbolType symbolColor);
 			const std::string getAssetPathForSymbolType(SymbolType type) const;
 			const std::string getAssetPathForShadowType(SymbolType type) const;
 			const std::string getAssetPathForCellType(const Config::BoardLevel& level, CellType type) const;
@@ -53,6 +60,9 @@ namespace Match3
 
 			Config _config;
 			int _currentLevel = 0;
+
+			// One per symbol type, so a recycled symbol never has to swap its sprites
+			std::vector<SymbolPool> _symbolPools;
 		};
 	}
 }
\ No newline at end of file
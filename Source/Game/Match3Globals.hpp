@@ -28,6 +28,8 @@ namespace Match3
 			const int MinNumberMatches = 3;
 			const int MaxBoardSize = 1000;
 
+			const int PointsPerMatchedSymbol = 10;
+
 			const std::string SymbolSpriteRendererName = "SymbolRenderer";
 			const std::string ShadowSpriteRendererName = "ShadowRenderer";
 		}
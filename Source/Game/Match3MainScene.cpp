@@ -46,8 +46,6 @@ namespace MainSceneConstants
 
 	const Point2D SceneAnchorPoint = Point2D(0.5f, 0.5f);
 
-	const int PointsPerMatchedSymbol = 10;
-
 	const float SymbolAnimationDelayIncrement = 0.05f;
 	const Point2D SymbolAnimationTargetOffset = Point2D(40.0f, 0.0f);
 }
@@ -61,11 +59,20 @@ MainScene::MainScene(const Config& config)
 	setZIndex(Match3::Game::Globals::MainSceneZIndex);
 }
 
+MainScene::~MainScene()
+{
+	if (_titleLayoutId != Framework::Core::Engine::InvalidTextLayoutId && hasEngine())
+	{
+		getEngine()->releaseTextLayout(_titleLayoutId);
+	}
+}
+
 void MainScene::start()
 {
 	_factory = std::move(CreateGameObject<Game::Factory>(_config));
 
 	setupBackground();
+	setupTitle();
 	setupBoard();
 	setupScoreRenderers();
 }
@@ -121,6 +128,14 @@ void MainScene::setupBackground()
 	addGameObject(background);
 }
 
+void MainScene::setupTitle()
+{
+	using namespace MainSceneConstants;
+
+	_titleLayoutId = getEngine()->createTextLayout(GameTitle);
+	_titleYOffsets.resize(GameTitle.size());
+}
+
 #pragma region - HUD
 float MainScene::getTitleWidth() const
 {
@@ -147,16 +162,14 @@ void MainScene::renderTitle(float dt)
 
 	const Size& screenSize = getEngine()->getScreenSize();
 
-	std::vector<float> yOffsets;
-
-	for (size_t numLetter = 0; numLetter < GameTitle.size(); ++numLetter)
+	for (size_t numLetter = 0; numLetter < _titleYOffsets.size(); ++numLetter)
 	{
 		float phaseShiftedTime = _titleAnimationTime + numLetter * GameTitleCharacterPhaseShiftTime;
-		yOffsets.push_back(GameTitleAnimationStrength * glm::sin(phaseShiftedTime * 2.0f * glm::pi<float>() / GameTitlePeriodSecs));
+		_titleYOffsets[numLetter] = GameTitleAnimationStrength * glm::sin(phaseShiftedTime * 2.0f * glm::pi<float>() / GameTitlePeriodSecs);
 	}
 
 	const Point2D& mainTitlePosition = getTitleTextPosition();
-	getEngine()->renderText(GameTitle, mainTitlePosition, yOffsets, Match3::Game::Globals::TextRenderingZIndex, GameTitleColor, 0.0f, GameTitleScale);
+	getEngine()->renderTextLayout(_titleLayoutId, mainTitlePosition, _titleYOffsets, Match3::Game::Globals::TextRenderingZIndex, GameTitleColor, 0.0f, GameTitleScale);
 }
 
 Point2D MainScene::getTitleTextPosition() const
@@ -198,6 +211,8 @@ void MainScene::onSymbolFlyAnimationFinished(SymbolPtrType symbol)
 {
 	incrementScore();
 	removeGameObject(*symbol);
+
+	_board->recycleSymbol(std::move(symbol));
 }
 
 #pragma region - Animations
@@ -222,7 +237,7 @@ void MainScene::incrementMoves()
 
 void MainScene::incrementScore()
 {
-	_scoreRenderer->addScore(MainSceneConstants::PointsPerMatchedSymbol);
+	_scoreRenderer->addScore(Globals::PointsPerMatchedSymbol);
 }
 
 #pragma region - Utils
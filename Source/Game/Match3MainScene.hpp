@@ -9,6 +9,7 @@
 #include "Match3MainScene.fwd.hpp"
 
 #include "Framework/Core/Scene.hpp"
+#include "Framework/Core/Engine.hpp"
 #include "Framework/Utils/Utils.hpp"
 
 #include "Match3Board.hpp"
@@ -25,7 +26,7 @@ namespace Match3
 		{
 		public:
 			MainScene(const Config& config);
-			~MainScene() = default;
+			~MainScene();
 
 			void start() override;
 			void update(float dt) override;
@@ -46,6 +47,7 @@ namespace Match3
 			void setupBoard();
 			void setupScoreRenderers();
 			void setupBackground();
+			void setupTitle();
 
 #pragma region - HUD
 			float getTitleWidth() const;
@@ -72,6 +74,8 @@ namespace Match3
 			Types::ScoreRenderer::PtrType _scoreRenderer;
 			Types::ScoreRenderer::PtrType _movesCountRenderer;
 			float _titleAnimationTime = 0.0f;
+			Framework::Types::TextLayoutId _titleLayoutId = Framework::Core::Engine::InvalidTextLayoutId;
+			std::vector<float> _titleYOffsets;
 		};
 	}
 }
@@ -0,0 +1,378 @@
+//
+// Match3MatchFinder.cpp
+//
+// @author Roberto Cano
+//
+
+#include "Match3MatchFinder.hpp"
+
+#include <cassert>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "Match3Globals.hpp"
+
+using namespace Match3;
+using namespace Match3::Game;
+
+namespace MatchFinderConstants
+{
+	const int NumSymbolTypes = static_cast<int>(Types::Symbol::Type::_end);
+	const int RunLength = Match3::Game::Globals::MinNumberMatches;
+}
+
+namespace
+{
+	using Word = CellMask::Word;
+
+	int CountTrailingZeros(Word word)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	int CountBits(Word word)
+	{
+#if defined(_MSC_VER)
+		return static_cast<int>(__popcnt64(word));
+#else
+		return __builtin_popcountll(word);
+#endif
+	}
+
+	// Column x of the result is column x + shift of the row, across word boundaries
+	void ShiftTowardsFirstColumn(const Word* row, Word* result, int numWords, int shift)
+	{
+		for (int i = 0; i < numWords; ++i)
+		{
+			const Word carry = (shift > 0 && i + 1 < numWords) ? row[i + 1] << (CellMask::WordBits - shift) : 0;
+			result[i] = (row[i] >> shift) | carry;
+		}
+	}
+
+	// Column x + shift of the result is column x of the row, ORed into the result
+	void OrShiftedTowardsLastColumn(const Word* row, Word* result, int numWords, int shift)
+	{
+		for (int i = 0; i < numWords; ++i)
+		{
+			const Word carry = (shift > 0 && i > 0) ? row[i - 1] >> (CellMask::WordBits - shift) : 0;
+			result[i] |= (row[i] << shift) | carry;
+		}
+	}
+}
+
+#pragma region - CellMask
+CellMask::CellMask(const Size& size)
+	: _size(size)
+	, _numWordsPerRow((size.width + WordBits - 1) / WordBits)
+{
+	_words.resize(_numWordsPerRow * size.height, 0);
+}
+
+const CellMask::Size& CellMask::getSize() const
+{
+	return _size;
+}
+
+int CellMask::getNumWordsPerRow() const
+{
+	return _numWordsPerRow;
+}
+
+void CellMask::set(const Position& position)
+{
+	assert(position.x >= 0 && position.x < _size.width);
+	assert(position.y >= 0 && position.y < _size.height);
+	getRow(position.y)[position.x / WordBits] |= Word(1) << (position.x % WordBits);
+}
+
+void CellMask::reset(const Position& position)
+{
+	assert(position.x >= 0 && position.x < _size.width);
+	assert(position.y >= 0 && position.y < _size.height);
+	getRow(position.y)[position.x / WordBits] &= ~(Word(1) << (position.x % WordBits));
+}
+
+bool CellMask::test(const Position& position) const
+{
+	assert(position.x >= 0 && position.x < _size.width);
+	assert(position.y >= 0 && position.y < _size.height);
+	return (getRow(position.y)[position.x / WordBits] >> (position.x % WordBits)) & 1;
+}
+
+void CellMask::clear()
+{
+	std::fill(_words.begin(), _words.end(), 0);
+}
+
+bool CellMask::isEmpty() const
+{
+	for (Word word : _words)
+	{
+		if (word != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int CellMask::count() const
+{
+	int numBits = 0;
+	for (Word word : _words)
+	{
+		numBits += CountBits(word);
+	}
+	return numBits;
+}
+
+void CellMask::forEach(const PositionFunc& func) const
+{
+	for (int row = 0; row < _size.height; ++row)
+	{
+		const Word* rowWords = getRow(row);
+		for (int i = 0; i < _numWordsPerRow; ++i)
+		{
+			Word word = rowWords[i];
+			while (word != 0)
+			{
+				func(Position(i * WordBits + CountTrailingZeros(word), row));
+				word &= word - 1;
+			}
+		}
+	}
+}
+
+CellMask& CellMask::operator|=(const CellMask& other)
+{
+	assert(_words.size() == other._words.size());
+	for (size_t i = 0; i < _words.size(); ++i)
+	{
+		_words[i] |= other._words[i];
+	}
+	return *this;
+}
+
+bool CellMask::operator==(const CellMask& other) const
+{
+	return _size.width == other._size.width && _size.height == other._size.height && _words == other._words;
+}
+
+bool CellMask::operator!=(const CellMask& other) const
+{
+	return !(*this == other);
+}
+
+bool CellMask::isRowEmpty(int row) const
+{
+	const Word* rowWords = getRow(row);
+	for (int i = 0; i < _numWordsPerRow; ++i)
+	{
+		if (rowWords[i] != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+CellMask::Word* CellMask::getRow(int row)
+{
+	return _words.data() + row * _numWordsPerRow;
+}
+
+const CellMask::Word* CellMask::getRow(int row) const
+{
+	return _words.data() + row * _numWordsPerRow;
+}
+
+#pragma region - MatchFinder
+MatchFinder::MatchFinder(const Size& size)
+	: _size(size)
+	, _symbolMasks(MatchFinderConstants::NumSymbolTypes, CellMask(size))
+	, _cellTypes(size.width * size.height, SymbolType::_end)
+	, _dirtyCells(size)
+	, _runStarts(_dirtyCells.getNumWordsPerRow())
+	, _shiftedRow(_dirtyCells.getNumWordsPerRow())
+{
+	assert(MatchFinderConstants::RunLength > 0 && MatchFinderConstants::RunLength <= CellMask::WordBits);
+}
+
+void MatchFinder::setSymbol(const Position& position, SymbolType type)
+{
+	assert(type != SymbolType::_end);
+
+	clearSymbol(position);
+
+	_cellTypes[position.y * _size.width + position.x] = type;
+	_symbolMasks[static_cast<int>(type)].set(position);
+	_dirtyCells.set(position);
+}
+
+void MatchFinder::clearSymbol(const Position& position)
+{
+	SymbolType& cellType = _cellTypes[position.y * _size.width + position.x];
+	if (cellType != SymbolType::_end)
+	{
+		_symbolMasks[static_cast<int>(cellType)].reset(position);
+		cellType = SymbolType::_end;
+		_dirtyCells.set(position);
+	}
+}
+
+CellMask MatchFinder::findAllMatches() const
+{
+	using namespace MatchFinderConstants;
+
+	CellMask matches(_size);
+	for (const CellMask& symbols : _symbolMasks)
+	{
+		for (int row = 0; row < _size.height; ++row)
+		{
+			addHorizontalRuns(symbols, row, matches);
+		}
+		for (int firstRow = 0; firstRow + RunLength <= _size.height; ++firstRow)
+		{
+			addVerticalRuns(symbols, firstRow, matches);
+		}
+	}
+	return matches;
+}
+
+CellMask MatchFinder::findMatches(SymbolType type) const
+{
+	using namespace MatchFinderConstants;
+
+	assert(type != SymbolType::_end);
+
+	const CellMask& symbols = _symbolMasks[static_cast<int>(type)];
+
+	CellMask matches(_size);
+	for (int row = 0; row < _size.height; ++row)
+	{
+		addHorizontalRuns(symbols, row, matches);
+	}
+	for (int firstRow = 0; firstRow + RunLength <= _size.height; ++firstRow)
+	{
+		addVerticalRuns(symbols, firstRow, matches);
+	}
+	return matches;
+}
+
+CellMask MatchFinder::findMatchesInDirtyRegion() const
+{
+	using namespace MatchFinderConstants;
+
+	CellMask matches(_size);
+	for (int row = 0; row < _size.height; ++row)
+	{
+		if (_dirtyCells.isRowEmpty(row))
+		{
+			continue;
+		}
+
+		for (const CellMask& symbols : _symbolMasks)
+		{
+			addHorizontalRuns(symbols, row, matches);
+		}
+	}
+
+	for (int firstRow = 0; firstRow + RunLength <= _size.height; ++firstRow)
+	{
+		if (!isWindowDirty(firstRow))
+		{
+			continue;
+		}
+
+		for (const CellMask& symbols : _symbolMasks)
+		{
+			addVerticalRuns(symbols, firstRow, matches);
+		}
+	}
+	return matches;
+}
+
+const CellMask& MatchFinder::getDirtyRegion() const
+{
+	return _dirtyCells;
+}
+
+void MatchFinder::clearDirtyRegion()
+{
+	_dirtyCells.clear();
+}
+
+void MatchFinder::addHorizontalRuns(const CellMask& symbols, int row, CellMask& matches) const
+{
+	using namespace MatchFinderConstants;
+
+	const int numWords = symbols.getNumWordsPerRow();
+	const Word* rowWords = symbols.getRow(row);
+
+	// A run starts at x when x, x + 1, ... x + RunLength - 1 are all set. Columns past the
+	// board width are always clear, so no run starts too close to the edge
+	_runStarts.assign(rowWords, rowWords + numWords);
+	for (int shift = 1; shift < RunLength; ++shift)
+	{
+		ShiftTowardsFirstColumn(rowWords, _shiftedRow.data(), numWords, shift);
+		for (int i = 0; i < numWords; ++i)
+		{
+			_runStarts[i] &= _shiftedRow[i];
+		}
+	}
+
+	// Every start marks the whole run, longer runs are just overlapping starts
+	Word* matchedWords = matches.getRow(row);
+	for (int shift = 0; shift < RunLength; ++shift)
+	{
+		OrShiftedTowardsLastColumn(_runStarts.data(), matchedWords, numWords, shift);
+	}
+}
+
+void MatchFinder::addVerticalRuns(const CellMask& symbols, int firstRow, CellMask& matches) const
+{
+	using namespace MatchFinderConstants;
+
+	const int numWords = symbols.getNumWordsPerRow();
+
+	// Same as the horizontal runs, with whole rows as the shifted unit
+	for (int i = 0; i < numWords; ++i)
+	{
+		Word runStarts = symbols.getRow(firstRow)[i];
+		for (int offset = 1; offset < RunLength && runStarts != 0; ++offset)
+		{
+			runStarts &= symbols.getRow(firstRow + offset)[i];
+		}
+
+		if (runStarts != 0)
+		{
+			for (int offset = 0; offset < RunLength; ++offset)
+			{
+				matches.getRow(firstRow + offset)[i] |= runStarts;
+			}
+		}
+	}
+}
+
+bool MatchFinder::isWindowDirty(int firstRow) const
+{
+	using namespace MatchFinderConstants;
+
+	for (int offset = 0; offset < RunLength; ++offset)
+	{
+		if (!_dirtyCells.isRowEmpty(firstRow + offset))
+		{
+			return true;
+		}
+	}
+	return false;
+}
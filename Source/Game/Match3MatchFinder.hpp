@@ -0,0 +1,118 @@
+//
+// Match3MatchFinder.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include "Framework/Core/Types.hpp"
+
+#include "Match3Board.fwd.hpp"
+#include "Match3Symbol.fwd.hpp"
+
+namespace Match3
+{
+	namespace Game
+	{
+#pragma region - CellMask
+		//
+		// One bit per board cell. Every row starts on its own 64 bit word, column x of a row being
+		// bit x % 64 of its word x / 64, so a row of up to 64 cells is a single word
+		//
+		class CellMask final
+		{
+		public:
+			using Size = Framework::Types::Size;
+			using Position = Types::Board::Position;
+			using Word = uint64_t;
+			using PositionFunc = std::function<void(const Position& position)>;
+
+			static constexpr int WordBits = 64;
+
+			CellMask() = default;
+			explicit CellMask(const Size& size);
+
+			const Size& getSize() const;
+			int getNumWordsPerRow() const;
+
+			void set(const Position& position);
+			void reset(const Position& position);
+			bool test(const Position& position) const;
+			void clear();
+
+			bool isEmpty() const;
+			int count() const;
+
+			// Row by row, lowest column first
+			void forEach(const PositionFunc& func) const;
+
+			CellMask& operator|=(const CellMask& other);
+			bool operator==(const CellMask& other) const;
+			bool operator!=(const CellMask& other) const;
+
+			bool isRowEmpty(int row) const;
+
+			Word* getRow(int row);
+			const Word* getRow(int row) const;
+
+		private:
+			Size _size;
+			int _numWordsPerRow = 0;
+			std::vector<Word> _words;
+		};
+
+#pragma region - MatchFinder
+		//
+		// Keeps a CellMask per symbol type, updated as symbols come and go, and finds runs of at
+		// least Globals::MinNumberMatches with shifts and ANDs over whole rows, instead of walking
+		// the board cell by cell.
+		//
+		// Every changed cell is also flagged dirty. A new run has to go through one of them, so
+		// findMatchesInDirtyRegion() only looks at the rows of dirty cells and at the vertical
+		// windows that overlap them, which is the same as a full scan as long as the board was
+		// left without matches when the region was last cleared
+		//
+		class MatchFinder final
+		{
+		public:
+			using Size = Framework::Types::Size;
+			using Position = Types::Board::Position;
+			using SymbolType = Types::Symbol::Type;
+
+			MatchFinder() = default;
+			explicit MatchFinder(const Size& size);
+
+			void setSymbol(const Position& position, SymbolType type);
+			void clearSymbol(const Position& position);
+
+			// Cells in a horizontal or vertical run of any type
+			CellMask findAllMatches() const;
+			// Same, only for runs of one type
+			CellMask findMatches(SymbolType type) const;
+
+			// Runs crossing the cells changed since the last clearDirtyRegion()
+			CellMask findMatchesInDirtyRegion() const;
+			const CellMask& getDirtyRegion() const;
+			void clearDirtyRegion();
+
+		private:
+			void addHorizontalRuns(const CellMask& symbols, int row, CellMask& matches) const;
+			void addVerticalRuns(const CellMask& symbols, int firstRow, CellMask& matches) const;
+			bool isWindowDirty(int firstRow) const;
+
+			Size _size;
+			std::vector<CellMask> _symbolMasks;	// Indexed by symbol type
+			std::vector<SymbolType> _cellTypes;	// Row major, _end when empty
+			CellMask _dirtyCells;
+
+			// Scratch rows for the horizontal pass
+			mutable std::vector<CellMask::Word> _runStarts;
+			mutable std::vector<CellMask::Word> _shiftedRow;
+		};
+	}
+}
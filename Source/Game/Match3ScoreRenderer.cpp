@@ -9,6 +9,7 @@
 #include "Framework/Components/TextRenderer.hpp"
 #include "Framework/Components/SoundEmitter.hpp"
 #include "Framework/Core/Types.hpp"
+#include "Framework/Utils/Random.hpp"
 
 #include "Match3Factory.hpp"
 #include "Match3MainScene.hpp"
@@ -56,11 +57,6 @@ bool Match3::Game::ScoreRenderer::isSoundEnabled() const
 	return _isSoundEnabled;
 }
 
-void Match3::Game::ScoreRenderer::setupRandomGenerator()
-{
-	_randomGenerator = std::make_unique<Framework::Utils::RandomGenerator>(0, 9);
-}
-
 void Match3::Game::ScoreRenderer::setupFactory()
 {
 	const auto& scene = getOwner<MainScene>();
@@ -103,7 +99,7 @@ void Match3::Game::ScoreRenderer::triggerSoundEmitter()
 {
 	if (_isSoundEnabled)
 	{
-		int randomIndex = _randomGenerator->getValue();
+		int randomIndex = Framework::Utils::Random::Get().nextInt(0, 9);
 
 		float randomAngle = -glm::pi<float>() / 8.0f + randomIndex * glm::pi<float>() / 32.0f;
 		_soundEmitter->setRotation(randomAngle);
@@ -114,7 +110,6 @@ void Match3::Game::ScoreRenderer::triggerSoundEmitter()
 
 void Match3::Game::ScoreRenderer::start()
 {
-	setupRandomGenerator();
 	setupFactory();
 	setupTextRenderer();
 	setupSoundEmitter();
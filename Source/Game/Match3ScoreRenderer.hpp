@@ -33,7 +33,6 @@ namespace Match3
 			void start() override;
 
 		private:
-			void setupRandomGenerator();
 			void setupFactory();
 			void setupTextRenderer();
 			void setupSoundEmitter();
@@ -48,9 +47,6 @@ namespace Match3
 			Types::Factory::PtrType _factory;
 			Framework::Types::SoundEmitter::PtrType _soundEmitter;
 			Framework::Types::TextRenderer::PtrType _textRenderer;
-
-			using RandomGenerator = Framework::Utils::RandomGenerator;
-			std::unique_ptr<RandomGenerator> _randomGenerator;
 		};
 	}
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 #include "Framework/Core/Engine.hpp"
 #include "Framework/Components/SpriteRenderer.hpp"
+#include "Framework/Utils/Random.hpp"
 
 using namespace Framework::Core;
 using namespace Framework::Types;
@@ -43,16 +44,19 @@ Symbol::Symbol(Type type, const Size& size)
 	setZIndex(Match3::Game::Globals::SymbolNormalZIndex);
 	setAnchorPoint(SymbolConstants::AnchorPoint);
 
-	_randomGenerator = std::make_unique<RandomGenerator>(0, 90);
-
-	_upAndDownAnimInitPhase = static_cast<float>(_randomGenerator->getValue()) * 4.0f * glm::pi<float>() / 180.0f;
+	_upAndDownAnimInitPhase = static_cast<float>(Framework::Utils::Random::Get().nextInt(0, 90)) * 4.0f * glm::pi<float>() / 180.0f;
 }
 
 void Symbol::start()
+{
+	findSpriteRenderers();
+}
+
+void Symbol::findSpriteRenderers()
 {
 	using namespace Framework;
 
-	const std::set<InstanceId>& spriteRenderersIds = getComponentsIds<Components::SpriteRenderer>();
+	const std::vector<InstanceId>& spriteRenderersIds = getComponentsIds<Components::SpriteRenderer>();
 	for (const auto& instanceId : spriteRenderersIds)
 	{
 		SpriteRendererPtr spriteRenderer = getComponent<Components::SpriteRenderer>(instanceId);
@@ -69,46 +73,15 @@ void Symbol::start()
 	assert(_symbolSpriteRenderer && _shadowSpriteRenderer);
 }
 
-void Symbol::update(float dt)
+void Symbol::update(float /* dt */)
 {
 	if (_state != _newState)
 	{
 		processStateChange(_newState);
-		return;
 	}
 
-	switch (_state)
-	{
-		case State::Idle:
-		{
-			updateUpAndDownAnimation(dt);
-			break;
-		}
-		case State::Appearing:
-		{
-			if (!updateAppearingAnimation(dt))
-			{
-				_newState = State::Idle;
-			}
-			break;
-		}
-		case State::Selected:
-		{
-			updateSelectedAnimation(dt);
-			break;
-		}
-		case State::PossibleMove:
-		{
-			updatePossibleMoveAnimation(dt);
-			break;
-		}
-		case State::Dropping:
-		case State::Flying:
-		{
-			// Empty on purpose
-			break;
-		}
-	}
+	// Nothing else to do until the next state change, the animations run on their own
+	setUpdateEnabled(false);
 }
 
 Symbol::Type Symbol::getType() const
@@ -121,6 +94,13 @@ void Symbol::setCellPosition(const CellPosition& cellPosition)
 	_cellPosition = cellPosition;
 
 	updatePositionFromCellPosition();
+
+	// Running animations move around the old cell, they start over around the new one
+	if (_state == _newState && !_animationTracks.empty())
+	{
+		stopStateAnimation();
+		startStateAnimation();
+	}
 }
 
 const Symbol::CellPosition& Symbol::getCellPosition() const
@@ -138,44 +118,20 @@ Point2D Symbol::getLocalPositionFromCellPosition() const
 void Symbol::setState(State state)
 {
 	_newState = state;
+	setUpdateEnabled(true);
 }
 
 void Symbol::processStateChange(State newState)
 {
-	// TODO: Need a proper state machine here to handle exit state
-	switch (_state)
-	{
-		case State::Idle:
-		{
-			stopUpAndDownAnimation();
-			break;
-		}
-		case State::Appearing:
-		{
-			stopAppearingAnimation();
-			break;
-		}
-		case State::Selected:
-		{
-			stopSelectedAnimation();
-			break;
-		}
-		case State::PossibleMove:
-		{
-			stopPossibleMoveAnimation();
-			break;
-		}
-		case State::Dropping:
-		case State::Flying:
-		{
-			// Empty on purpose
-			break;
-		}
-	}
+	stopStateAnimation();
 
 	_state = newState;
 
-	// TODO: Same here for enter state
+	startStateAnimation();
+}
+
+void Symbol::startStateAnimation()
+{
 	switch (_state)
 	{
 		case State::Idle:
@@ -207,11 +163,58 @@ void Symbol::processStateChange(State newState)
 	}
 }
 
+void Symbol::stopStateAnimation()
+{
+	if (_animationTracks.empty())
+	{
+		return;
+	}
+
+	// Finished ones are simply ignored. Only our own tracks, a drop animation may be driving this same transform
+	AnimationSystem& animationSystem = AnimationSystem::Get();
+	for (AnimationSystem::TrackId track : _animationTracks)
+	{
+		animationSystem.stop(track);
+	}
+	_animationTracks.clear();
+
+	setRendererOpacity(1.0f);
+	setLocalRotation(0.0f);
+	setLocalScale(1.0f);
+	setZIndex(Match3::Game::Globals::SymbolNormalZIndex);
+	updatePositionFromCellPosition();
+}
+
 Symbol::State Symbol::getState() const
 {
 	return _state;
 }
 
+void Symbol::reset()
+{
+	// Its renderers are pooled as well and would keep drawing while it waits
+	if (!_symbolSpriteRenderer)
+	{
+		findSpriteRenderers();
+	}
+
+	stopStateAnimation();
+
+	setRendererVisible(false);
+	setRendererOpacity(1.0f);
+	setLocalRotation(0.0f);
+	setLocalScale(1.0f);
+
+	setZIndex(Match3::Game::Globals::SymbolNormalZIndex);
+	_state = State::Idle;
+	_newState = State::Idle;
+}
+
+void Symbol::reactivate()
+{
+	setState(State::Appearing);
+}
+
 void Symbol::updatePositionFromCellPosition()
 {
 	Point2D position = getLocalPositionFromCellPosition();
@@ -247,104 +250,92 @@ bool Symbol::onMouseDragStopped(GameObject& gameObject, const Point2D& lastPosit
 }
 
 void Symbol::startSelectedAnimation()
-{
-	// TODO: animation system
-	_animationTime = 0.0f;
-	setZIndex(Match3::Game::Globals::SymbolOnTopZIndex);
-}
-
-void Symbol::updateSelectedAnimation(float dt)
 {
 	using namespace SymbolConstants;
 
-	_animationTime += dt;
-
-	Point2D position = getLocalPositionFromCellPosition();
-	position.y -= MoveAnimationAmplitude * (1.0f + glm::sin(MoveAnimationInitPhase + _animationTime * MoveAnimationPhase));
+	setZIndex(Match3::Game::Globals::SymbolOnTopZIndex);
 
-	setLocalPosition(position);
-}
+	AnimationSystem::Oscillation bounce;
+	bounce.property = AnimationSystem::Property::PositionY;
+	bounce.base = getLocalPositionFromCellPosition().y - MoveAnimationAmplitude;
+	bounce.amplitude = -MoveAnimationAmplitude;
+	bounce.angularSpeed = MoveAnimationPhase;
+	bounce.phase = MoveAnimationInitPhase;
 
-void Symbol::stopSelectedAnimation()
-{
-	updatePositionFromCellPosition();
-	setZIndex(Match3::Game::Globals::SymbolNormalZIndex);
+	_animationTracks.push_back(AnimationSystem::Get().play(*this, bounce));
 }
 
 void Symbol::startPossibleMoveAnimation()
-{
-	_animationTime = 0.0;
-}
-
-void Symbol::updatePossibleMoveAnimation(float dt)
 {
 	using namespace SymbolConstants;
 
-	_animationTime += dt;
-
-	float PI2 = glm::pi<float>();
-	float scaler = glm::sin(_animationTime * PI2 / PossibleMoveAnimationTimeSec);
-	float rotation = scaler * PI2 / PossibleMoveAnimationAngleScale;
+	AnimationSystem& animationSystem = AnimationSystem::Get();
 
-	_symbolSpriteRenderer->setRotation(rotation);
+	AnimationSystem::Oscillation wiggle;
+	wiggle.property = AnimationSystem::Property::Rotation;
+	wiggle.amplitude = glm::pi<float>() / PossibleMoveAnimationAngleScale;
+	wiggle.angularSpeed = glm::pi<float>() / PossibleMoveAnimationTimeSec;
 
-	Point2D position = getLocalPositionFromCellPosition();
-	position.y -= PossibleMoveAnimationAmplitude * (1.0f + glm::sin(PossibleMoveAnimationInitPhase + _animationTime * PossibleMoveAnimationPhase)) / 2.0f;
+	AnimationSystem::Oscillation bounce;
+	bounce.property = AnimationSystem::Property::PositionY;
+	bounce.base = getLocalPositionFromCellPosition().y - PossibleMoveAnimationAmplitude / 2.0f;
+	bounce.amplitude = -PossibleMoveAnimationAmplitude / 2.0f;
+	bounce.angularSpeed = PossibleMoveAnimationPhase;
+	bounce.phase = PossibleMoveAnimationInitPhase;
 
-	setLocalPosition(position);
-}
-
-void Symbol::stopPossibleMoveAnimation()
-{
-	_symbolSpriteRenderer->setRotation(0.0f);
-	updatePositionFromCellPosition();
+	_animationTracks.push_back(animationSystem.play(*this, wiggle));
+	_animationTracks.push_back(animationSystem.play(*this, bounce));
 }
 
 void Symbol::startAppearingAnimation()
-{
-	_animationTime = 0.0f;
-
-	setRendererVisible(true);
-	setRendererRotation(0.0f);
-	setRendererOpacity(0.0f);
-	setRendererScale(0.0f);
-}
-
-bool Symbol::updateAppearingAnimation(float dt)
 {
 	using namespace SymbolConstants;
 
-	_animationTime += dt;
-	if (_animationTime > AppearingAnimationDuration)
-	{
-		stopAppearingAnimation();
-		return false;
-	}
+	AnimationSystem& animationSystem = AnimationSystem::Get();
 
-	float animationPercent = _animationTime / AppearingAnimationDuration;
+	setRendererVisible(true);
 
-	float rotation = AppearingAnimationNumTurns * animationPercent * 2.0f * glm::pi<float>();
+	AnimationSystem::Tween fadeIn;
+	fadeIn.to = 1.0f;
+	fadeIn.duration = AppearingAnimationDuration;
 
-	setRendererRotation(rotation);
-	setRendererOpacity(animationPercent);
-	setRendererScale(animationPercent);
+	AnimationSystem::Tween spin;
+	spin.property = AnimationSystem::Property::Rotation;
+	spin.to = AppearingAnimationNumTurns * 2.0f * glm::pi<float>();
+	spin.duration = AppearingAnimationDuration;
 
-	updatePositionFromCellPosition();
+	AnimationSystem::Tween grow;
+	grow.property = AnimationSystem::Property::Scale;
+	grow.to = 1.0f;
+	grow.duration = AppearingAnimationDuration;
 
-	return true;
+	_animationTracks.push_back(animationSystem.play(*this, _symbolSpriteRenderer->getOpacityTarget(), fadeIn));
+	_animationTracks.push_back(animationSystem.play(*this, _shadowSpriteRenderer->getOpacityTarget(), fadeIn));
+	_animationTracks.push_back(animationSystem.play(*this, spin));
+	_animationTracks.push_back(animationSystem.play(*this, grow, [this](AnimationSystem::TrackId)
+	{
+		setState(State::Idle);
+	}));
 }
 
-void Symbol::stopAppearingAnimation()
+void Symbol::startUpAndDownAnimation()
 {
-	setRendererRotation(0.0f);
-	setRendererOpacity(1.0f);
-	setRendererScale(1.0f);
+	using namespace SymbolConstants;
+
+	AnimationSystem::Oscillation bounce;
+	bounce.property = AnimationSystem::Property::PositionY;
+	bounce.base = getLocalPositionFromCellPosition().y;
+	bounce.amplitude = -UpAndDownAnimationAmplitude;
+	bounce.angularSpeed = UpAndDownAnimationPhase;
+	bounce.phase = _upAndDownAnimInitPhase;
+
+	_animationTracks.push_back(AnimationSystem::Get().play(*this, bounce));
 }
 
 void Symbol::setRendererVisible(bool visible)
 {
-	_symbolSpriteRenderer->setVisible(true);
-	_shadowSpriteRenderer->setVisible(true);
+	_symbolSpriteRenderer->setVisible(visible);
+	_shadowSpriteRenderer->setVisible(visible);
 }
 
 void Symbol::setRendererOpacity(float opacity)
@@ -352,37 +343,3 @@ void Symbol::setRendererOpacity(float opacity)
 	_symbolSpriteRenderer->setOpacity(opacity);
 	_shadowSpriteRenderer->setOpacity(opacity);
 }
-
-void Symbol::setRendererRotation(float rotation)
-{
-	_symbolSpriteRenderer->setRotation(rotation);
-	_shadowSpriteRenderer->setRotation(rotation);
-}
-
-void Symbol::setRendererScale(float scale)
-{
-	_symbolSpriteRenderer->setOpacity(scale);
-	_shadowSpriteRenderer->setOpacity(scale);
-}
-
-void Symbol::startUpAndDownAnimation()
-{
-	_animationTime = 0.0f;
-}
-
-void Symbol::updateUpAndDownAnimation(float dt)
-{
-	using namespace SymbolConstants;
-
-	_animationTime += dt;
-
-	Point2D position = getLocalPositionFromCellPosition();
-	position.y -= UpAndDownAnimationAmplitude * glm::sin(_upAndDownAnimInitPhase + _animationTime * UpAndDownAnimationPhase);
-
-	setLocalPosition(position);
-}
-
-void Symbol::stopUpAndDownAnimation()
-{
-	_animationTime = 0.0f;
-}
\ No newline at end of file
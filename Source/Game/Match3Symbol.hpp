@@ -12,6 +12,7 @@
 
 #include "Framework/Core/Types.hpp"
 #include "Framework/Core/GameObject.hpp"
+#include "Framework/Core/AnimationSystem.hpp"
 #include "Framework/Components/MouseHandler.hpp"
 #include "Framework/Utils/Utils.hpp"
 
@@ -49,9 +50,14 @@ namespace Match3
 			void setState(State state);
 			State getState() const;
 
+			// GameObjectPool hooks
+			void reset();
+			void reactivate();
+
 		private:
 			using SpriteRendererPtr = Framework::Types::SpriteRenderer::PtrType;
 
+			void findSpriteRenderers();
 			void processStateChange(State newState);
 
 			friend class MouseHandling; // Only MouseHandling can send mouse events
@@ -62,27 +68,19 @@ namespace Match3
 
 			void setRendererVisible(bool visible);
 			void setRendererOpacity(float opacity);
-			void setRendererRotation(float rotation);
-			void setRendererScale(float scale);
 
 			Point2D getLocalPositionFromCellPosition() const;
 			void updatePositionFromCellPosition();
 
-			void startSelectedAnimation();
-			void updateSelectedAnimation(float dt);
-			void stopSelectedAnimation();
+			// Every state animation is a set of tracks in the AnimationSystem, the symbol itself
+			// only wakes up to switch states
+			void startStateAnimation();
+			void stopStateAnimation();
 
+			void startSelectedAnimation();
 			void startPossibleMoveAnimation();
-			void updatePossibleMoveAnimation(float dt);
-			void stopPossibleMoveAnimation();
-
 			void startAppearingAnimation();
-			bool updateAppearingAnimation(float dt);
-			void stopAppearingAnimation();
-
 			void startUpAndDownAnimation();
-			void updateUpAndDownAnimation(float dt);
-			void stopUpAndDownAnimation();
 
 			CellPosition _cellPosition;
 			Type _type = Type::_end;
@@ -92,11 +90,8 @@ namespace Match3
 			SpriteRendererPtr _symbolSpriteRenderer;
 			SpriteRendererPtr _shadowSpriteRenderer;
 
+			std::vector<Framework::Core::AnimationSystem::TrackId> _animationTracks;
 			float _upAndDownAnimInitPhase = 0.0f;
-			float _animationTime = 0.0f;
-
-			using RandomGenerator = Framework::Utils::RandomGenerator;
-			std::unique_ptr<RandomGenerator> _randomGenerator;
 		};
 
 	}
@@ -64,8 +64,11 @@ void SymbolFlyAnimation::update(float dt)
 			{
 				_state = State::Finished;
 
-				getOwner<MainScene>().removeGameObject(*_symbol);
-				getOwner<MainScene>().onSymbolFlyAnimationFinished(_symbol);
+				MainScene& mainScene = getOwner<MainScene>();
+				mainScene.onSymbolFlyAnimationFinished(std::move(_symbol));
+
+				// The symbol is recycled from now on, we are done too
+				mainScene.removeGameObject(*this);
 			}
 			break;
 		}
@@ -119,7 +122,7 @@ void SymbolFlyAnimation::updateSymbolRenderers(float animDirectionLength)
 {
 	using namespace SymbolFlyAnimationConstants;
 
-	const std::set<Framework::Types::InstanceId>& spriteRendererIds = _symbol->getComponentsIds<Framework::Components::SpriteRenderer>();
+	const std::vector<Framework::Types::InstanceId>& spriteRendererIds = _symbol->getComponentsIds<Framework::Components::SpriteRenderer>();
 
 	float factor = animDirectionLength / SymbolAnimationFadeLength;
 	for (const auto& instanceId : spriteRendererIds)
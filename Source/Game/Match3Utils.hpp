@@ -26,18 +26,19 @@ namespace Match3
 				_data.resize(size.width * size.height);
 			}
 
+			// Row major, x being the column
 			T& at(const Position& position)
 			{
-				assert(position.x < _size.width);
-				assert(position.y < _size.height);
-				return _data.at(position.x * _size.width + position.y);
+				assert(position.x >= 0 && position.x < _size.width);
+				assert(position.y >= 0 && position.y < _size.height);
+				return _data[position.y * _size.width + position.x];
 			}
 
 			const T& at(const Position& position) const
 			{
-				assert(position.x < _size.width);
-				assert(position.y < _size.height);
-				return _data.at(position.x * _size.width + position.y);
+				assert(position.x >= 0 && position.x < _size.width);
+				assert(position.y >= 0 && position.y < _size.height);
+				return _data[position.y * _size.width + position.x];
 			}
 
 			const Size& getSize() const
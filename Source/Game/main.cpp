@@ -6,12 +6,67 @@
 
 #include "Match3MainScene.hpp"
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
 #include "Framework/Core/Factory.hpp"
 #include "Engine/SDLEngine.hpp"
+#include "Engine/HeadlessEngine.hpp"
 
 #include "Match3Symbol.fwd.hpp"
 #include "Match3Cell.fwd.hpp"
 
+namespace MainConstants
+{
+	// Frames played by a headless run when --frames is not given
+	const uint32_t DefaultHeadlessFrames = 600;
+}
+
+namespace
+{
+	struct LaunchOptions
+	{
+		bool isHeadless = false;
+		uint32_t numHeadlessFrames = MainConstants::DefaultHeadlessFrames;
+	};
+
+	// --headless runs the game loop without window or GPU, for --frames frames, and prints its stats
+	LaunchOptions ParseLaunchOptions(int argc, char *argv[])
+	{
+		LaunchOptions options;
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], "--headless") == 0)
+			{
+				options.isHeadless = true;
+			}
+			else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			{
+				options.numHeadlessFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			}
+		}
+		return options;
+	}
+
+	void RunHeadless(const Match3::Game::Config& config, Framework::Types::Scene::PtrType scene, uint32_t numFrames)
+	{
+		Headless::HeadlessSettings headlessSettings;
+		headlessSettings.maxFrames = numFrames;
+
+		auto engine = Headless::Engine::Create(config.engineSettings, headlessSettings);
+		engine->start(scene);
+
+		const Headless::Engine::FrameStats& stats = engine->getFrameStats();
+		const double numFramesPlayed = stats.numFrames > 0 ? static_cast<double>(stats.numFrames) : 1.0;
+
+		std::printf("Headless run, %u frames, %.2f simulated seconds\n", stats.numFrames, stats.simulatedSeconds);
+		std::printf("  update          : %.3f ms/frame\n", stats.updateSeconds * 1000.0 / numFramesPlayed);
+		std::printf("  sprite commands : %.1f per frame\n", stats.numSpriteCommands / numFramesPlayed);
+		std::printf("  text commands   : %.1f per frame\n", (stats.numTextCommands + stats.numTextLayoutCommands) / numFramesPlayed);
+	}
+}
+
 int main(int argc, char *argv[])
 {
 	using namespace Match3::Game;
@@ -58,7 +113,16 @@ int main(int argc, char *argv[])
 	level1.levelConfig = std::move(levelData);
 	config.levels.push_back(std::move(level1));
 
+	const LaunchOptions launchOptions = ParseLaunchOptions(argc, argv);
+
 	auto mainScene = Framework::Core::Factory::CreateScene<MainScene>(config);
+
+	if (launchOptions.isHeadless)
+	{
+		RunHeadless(config, mainScene, launchOptions.numHeadlessFrames);
+		return 0;
+	}
+
 	auto engine = SDL::Engine::Create(config.engineSettings);
 
 	engine->start(mainScene);
@@ -0,0 +1,415 @@
+//
+// Match3Balancer.cpp
+//
+// @author Roberto Cano
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <limits>
+
+#include "Match3Simulation.hpp"
+#include "Game/Match3Globals.hpp"
+#include "Game/Match3Symbol.fwd.hpp"
+
+using namespace Match3;
+using namespace Match3::Tools;
+
+//
+// Plays a batch of headless games with the given drop rates and reports how they went: points
+// per move, cascade lengths and how often the board runs out of moves. With targets and a number
+// of search iterations, it also looks for the drop rates that get closest to them.
+//
+// Every evaluation replays the same seeds, so two sets of rates are always compared over the
+// same games and the search is not chasing noise
+//
+
+namespace BalancerConstants
+{
+	using SymbolType = Match3::Types::Symbol::Type;
+
+	const int NumSymbolTypes = static_cast<int>(SymbolType::_end);
+
+	// Indexed by symbol type
+	const char* const SymbolNames[NumSymbolTypes] = { "Candy", "Cookie", "Donut", "Muffin", "Pie" };
+
+	// Same as the game, see main.cpp
+	const float DefaultDropRate = 1.0f / NumSymbolTypes;
+
+	const float InitialSearchStep = 0.05f;
+	const float MinSearchStep = 0.005f;
+	const float MinDropRate = 0.02f;
+
+	// Relative errors are taken against at least this, so a target of zero still works
+	const double MinTargetScale = 0.01;
+
+	const int HistogramBarWidth = 40;
+}
+
+namespace
+{
+	// Negative when not set
+	struct Targets
+	{
+		double pointsPerMove = -1.0;
+		double meanCascadeLength = -1.0;
+		double deadBoardRate = -1.0;
+
+		bool isEmpty() const
+		{
+			return pointsPerMove < 0.0 && meanCascadeLength < 0.0 && deadBoardRate < 0.0;
+		}
+	};
+
+	struct Options
+	{
+		SimulationSettings settings;
+		Targets targets;
+		uint32_t numThreads = 0;
+		uint32_t numSearchIterations = 0;
+	};
+
+	void PrintUsage(const char* program)
+	{
+		std::printf(
+			"Usage: %s [options]\n"
+			"  --board WxH            board size in cells (8x8)\n"
+			"  --rates r0,r1,...      drop rate of every symbol type, in enum order (%.2f each)\n"
+			"  --games N              games per evaluation (1000)\n"
+			"  --moves N              moves per game (30)\n"
+			"  --seed N               seed of the first game (1)\n"
+			"  --threads N            threads to play on, 0 for every core (0)\n"
+			"  --target-points X      points per move to aim for\n"
+			"  --target-cascade X     mean cascade length to aim for\n"
+			"  --target-dead X        dead boards per move to aim for\n"
+			"  --search N             iterations of the drop rate search (0)\n",
+			program, BalancerConstants::DefaultDropRate);
+	}
+
+	bool ParseRates(const char* text, std::vector<float>& rates)
+	{
+		rates.clear();
+
+		const char* current = text;
+		for (;;)
+		{
+			char* end = nullptr;
+			const float rate = std::strtof(current, &end);
+			if (end == current || rate < 0.0f)
+			{
+				return false;
+			}
+			rates.push_back(rate);
+
+			if (*end == '\0')
+			{
+				break;
+			}
+			if (*end != ',')
+			{
+				return false;
+			}
+			current = end + 1;
+		}
+
+		return static_cast<int>(rates.size()) == BalancerConstants::NumSymbolTypes;
+	}
+
+	bool ParseArguments(int argc, char** argv, Options& options)
+	{
+		using namespace BalancerConstants;
+
+		options.settings.dropRates.assign(NumSymbolTypes, DefaultDropRate);
+
+		for (int i = 1; i < argc; ++i)
+		{
+			const char* option = argv[i];
+			if (i + 1 >= argc)
+			{
+				std::fprintf(stderr, "Missing value for %s\n", option);
+				return false;
+			}
+			const char* value = argv[++i];
+
+			bool isValid = true;
+			if (std::strcmp(option, "--board") == 0)
+			{
+				int width = 0;
+				int height = 0;
+				// A run has to fit in at least one direction, or no move can ever match
+				isValid = std::sscanf(value, "%dx%d", &width, &height) == 2 && width > 0 && height > 0 &&
+					std::max(width, height) >= Game::Globals::MinNumberMatches;
+				options.settings.boardSize = Framework::Types::Size(width, height);
+			}
+			else if (std::strcmp(option, "--rates") == 0)
+			{
+				isValid = ParseRates(value, options.settings.dropRates);
+			}
+			else if (std::strcmp(option, "--games") == 0)
+			{
+				options.settings.numGames = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(option, "--moves") == 0)
+			{
+				options.settings.movesPerGame = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(option, "--seed") == 0)
+			{
+				options.settings.seed = std::strtoull(value, nullptr, 10);
+			}
+			else if (std::strcmp(option, "--threads") == 0)
+			{
+				options.numThreads = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(option, "--target-points") == 0)
+			{
+				options.targets.pointsPerMove = std::strtod(value, nullptr);
+			}
+			else if (std::strcmp(option, "--target-cascade") == 0)
+			{
+				options.targets.meanCascadeLength = std::strtod(value, nullptr);
+			}
+			else if (std::strcmp(option, "--target-dead") == 0)
+			{
+				options.targets.deadBoardRate = std::strtod(value, nullptr);
+			}
+			else if (std::strcmp(option, "--search") == 0)
+			{
+				options.numSearchIterations = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option %s\n", option);
+				return false;
+			}
+
+			if (!isValid)
+			{
+				std::fprintf(stderr, "Invalid value for %s: %s\n", option, value);
+				return false;
+			}
+		}
+
+		// Fewer than two symbols can never fill a board without matches
+		const auto numUsedTypes = std::count_if(options.settings.dropRates.begin(), options.settings.dropRates.end(), [](float rate)
+		{
+			return rate > 0.0f;
+		});
+		if (numUsedTypes < 2)
+		{
+			std::fprintf(stderr, "At least two symbol types need a drop rate\n");
+			return false;
+		}
+
+		if (options.numSearchIterations > 0 && options.targets.isEmpty())
+		{
+			std::fprintf(stderr, "The search needs at least one target\n");
+			return false;
+		}
+
+		return options.settings.numGames > 0 && options.settings.movesPerGame > 0;
+	}
+
+	void Normalize(std::vector<float>& rates)
+	{
+		float total = 0.0f;
+		for (float rate : rates)
+		{
+			total += rate;
+		}
+		for (float& rate : rates)
+		{
+			rate /= total;
+		}
+	}
+
+	double GetRelativeError(double value, double target)
+	{
+		if (target < 0.0)
+		{
+			return 0.0;
+		}
+
+		const double error = (value - target) / std::max(target, BalancerConstants::MinTargetScale);
+		return error * error;
+	}
+
+	double GetError(const SimulationStats& stats, const Targets& targets)
+	{
+		return GetRelativeError(stats.getPointsPerMove(), targets.pointsPerMove) +
+			GetRelativeError(stats.getMeanCascadeLength(), targets.meanCascadeLength) +
+			GetRelativeError(stats.getDeadBoardRate(), targets.deadBoardRate);
+	}
+
+	void PrintRates(const std::vector<float>& rates)
+	{
+		using namespace BalancerConstants;
+
+		for (int type = 0; type < NumSymbolTypes; ++type)
+		{
+			std::printf("%s%s %.3f", type > 0 ? ", " : "  ", SymbolNames[type], rates[type]);
+		}
+		std::printf("\n");
+	}
+
+	void PrintStats(const SimulationStats& stats, double seconds)
+	{
+		using namespace BalancerConstants;
+
+		std::printf("  games %llu, moves %llu in %.2f s, %.2f M moves/min\n",
+			static_cast<unsigned long long>(stats.numGames), static_cast<unsigned long long>(stats.numMoves),
+			seconds, stats.numMoves / seconds * 60.0 / 1000000.0);
+		std::printf("  points per move      : %.2f (deviation %.2f)\n", stats.getPointsPerMove(), stats.getPointsPerMoveDeviation());
+		std::printf("  mean cascade length  : %.3f\n", stats.getMeanCascadeLength());
+		std::printf("  dead boards per move : %.5f (%llu)\n", stats.getDeadBoardRate(), static_cast<unsigned long long>(stats.numDeadBoards));
+
+		std::printf("  cascade lengths\n");
+		for (int length = 1; length <= SimulationStats::MaxCascadeLength; ++length)
+		{
+			const double share = stats.getCascadeShare(length);
+			const int barWidth = static_cast<int>(share * HistogramBarWidth + 0.5);
+
+			std::printf("    %2d%s %7.3f%% %s\n", length, length == SimulationStats::MaxCascadeLength ? "+" : " ",
+				share * 100.0, std::string(barWidth, '#').c_str());
+		}
+	}
+
+	SimulationStats Evaluate(Simulation& simulation, SimulationSettings& settings, const std::vector<float>& rates, double& seconds)
+	{
+		settings.dropRates = rates;
+
+		const auto start = std::chrono::steady_clock::now();
+		SimulationStats stats = simulation.run(settings);
+		const auto end = std::chrono::steady_clock::now();
+
+		seconds = std::chrono::duration<double>(end - start).count();
+		return stats;
+	}
+
+	//
+	// Pattern search on the simplex of drop rates: every iteration tries moving a step of
+	// probability from each type to each other one, keeps the best candidate if it beats the
+	// current rates and halves the step otherwise
+	//
+	std::vector<float> SearchDropRates(Simulation& simulation, Options& options, std::vector<float> rates)
+	{
+		using namespace BalancerConstants;
+
+		double seconds = 0.0;
+		const SimulationStats startStats = Evaluate(simulation, options.settings, rates, seconds);
+		double bestError = startStats.isUnplayable ? std::numeric_limits<double>::max() : GetError(startStats, options.targets);
+		float step = InitialSearchStep;
+
+		for (uint32_t iteration = 0; iteration < options.numSearchIterations && step >= MinSearchStep; ++iteration)
+		{
+			std::vector<float> bestCandidate;
+
+			for (int from = 0; from < NumSymbolTypes; ++from)
+			{
+				// A type without any rate stays out of the game
+				const float available = rates[from] - MinDropRate;
+				if (available <= 0.0f)
+				{
+					continue;
+				}
+
+				for (int to = 0; to < NumSymbolTypes; ++to)
+				{
+					if (to == from || rates[to] <= 0.0f)
+					{
+						continue;
+					}
+
+					std::vector<float> candidate = rates;
+					const float amount = std::min(step, available);
+					candidate[from] -= amount;
+					candidate[to] += amount;
+
+					const SimulationStats stats = Evaluate(simulation, options.settings, candidate, seconds);
+					if (stats.isUnplayable)
+					{
+						continue;
+					}
+
+					const double error = GetError(stats, options.targets);
+					if (error < bestError)
+					{
+						bestError = error;
+						bestCandidate = std::move(candidate);
+					}
+				}
+			}
+
+			if (bestCandidate.empty())
+			{
+				step *= 0.5f;
+			}
+			else
+			{
+				rates = std::move(bestCandidate);
+			}
+
+			std::printf("Iteration %u, error %.6f, step %.4f\n", iteration + 1, bestError, step);
+			PrintRates(rates);
+		}
+
+		return rates;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseArguments(argc, argv, options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	const uint32_t numThreads = options.numThreads > 0 ? options.numThreads : std::max(1u, std::thread::hardware_concurrency());
+
+	// The calling thread plays too
+	Framework::Utils::JobSystem jobSystem(numThreads - 1);
+	Simulation simulation(jobSystem);
+
+	std::vector<float> rates = options.settings.dropRates;
+	Normalize(rates);
+
+	std::printf("Board %dx%d, %u games of %u moves, seed %llu, %u threads\n",
+		options.settings.boardSize.width, options.settings.boardSize.height,
+		options.settings.numGames, options.settings.movesPerGame,
+		static_cast<unsigned long long>(options.settings.seed), numThreads);
+
+	if (options.numSearchIterations > 0)
+	{
+		rates = SearchDropRates(simulation, options, rates);
+	}
+
+	double seconds = 0.0;
+	const SimulationStats stats = Evaluate(simulation, options.settings, rates, seconds);
+
+	if (stats.isUnplayable)
+	{
+		std::fprintf(stderr, "The board kept coming out without any possible move, these settings cannot be played\n");
+		PrintRates(rates);
+		return 1;
+	}
+
+	std::printf("Drop rates\n");
+	PrintRates(rates);
+	std::printf("Stats\n");
+	PrintStats(stats, seconds);
+
+	if (!options.targets.isEmpty())
+	{
+		std::printf("  error against targets: %.6f\n", GetError(stats, options.targets));
+	}
+
+	return 0;
+}
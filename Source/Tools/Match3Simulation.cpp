@@ -0,0 +1,174 @@
+//
+// Match3Simulation.cpp
+//
+// @author Roberto Cano
+//
+
+#include "Match3Simulation.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include "Framework/Utils/Random.hpp"
+#include "Game/Match3BoardModel.hpp"
+
+using namespace Match3;
+using namespace Match3::Tools;
+
+namespace SimulationConstants
+{
+	// Small enough to spread over every core, large enough for the chunk to outweigh queueing it
+	const size_t GamesPerChunk = 16;
+	// Dead boards in a row before a move gives up, more than any playable settings get near
+	const int MaxRegenerationsPerMove = 100;
+}
+
+#pragma region - SimulationStats
+void SimulationStats::merge(const SimulationStats& other)
+{
+	numGames += other.numGames;
+	numMoves += other.numMoves;
+	numDeadBoards += other.numDeadBoards;
+	totalPoints += other.totalPoints;
+	totalSquaredPoints += other.totalSquaredPoints;
+	isUnplayable = isUnplayable || other.isUnplayable;
+
+	for (size_t i = 0; i < cascadeLengths.size(); ++i)
+	{
+		cascadeLengths[i] += other.cascadeLengths[i];
+	}
+}
+
+double SimulationStats::getPointsPerMove() const
+{
+	return numMoves > 0 ? static_cast<double>(totalPoints) / numMoves : 0.0;
+}
+
+double SimulationStats::getPointsPerMoveDeviation() const
+{
+	if (numMoves == 0)
+	{
+		return 0.0;
+	}
+
+	const double mean = getPointsPerMove();
+	return std::sqrt(std::max(0.0, totalSquaredPoints / numMoves - mean * mean));
+}
+
+double SimulationStats::getMeanCascadeLength() const
+{
+	if (numMoves == 0)
+	{
+		return 0.0;
+	}
+
+	uint64_t totalLength = 0;
+	for (size_t length = 0; length < cascadeLengths.size(); ++length)
+	{
+		totalLength += length * cascadeLengths[length];
+	}
+	return static_cast<double>(totalLength) / numMoves;
+}
+
+double SimulationStats::getDeadBoardRate() const
+{
+	return numMoves > 0 ? static_cast<double>(numDeadBoards) / numMoves : 0.0;
+}
+
+double SimulationStats::getCascadeShare(int length) const
+{
+	assert(length >= 0 && length <= MaxCascadeLength);
+	return numMoves > 0 ? static_cast<double>(cascadeLengths[length]) / numMoves : 0.0;
+}
+
+#pragma region - Simulation
+Simulation::Simulation(Framework::Utils::JobSystem& jobSystem)
+	: _jobSystem(jobSystem)
+{
+	// Empty on purpose
+}
+
+SimulationStats Simulation::run(const SimulationSettings& settings)
+{
+	using namespace SimulationConstants;
+
+	const size_t numGames = settings.numGames;
+	const size_t numChunks = (numGames + GamesPerChunk - 1) / GamesPerChunk;
+
+	_chunkStats.assign(numChunks, SimulationStats());
+
+	_jobSystem.parallelFor(numGames, GamesPerChunk, [this, &settings](size_t chunk, size_t firstGame, size_t lastGame)
+	{
+		PlayGames(settings, firstGame, lastGame, _chunkStats[chunk]);
+	});
+
+	SimulationStats stats;
+	for (const SimulationStats& chunkStats : _chunkStats)
+	{
+		stats.merge(chunkStats);
+	}
+	return stats;
+}
+
+void Simulation::PlayGames(const SimulationSettings& settings, size_t firstGame, size_t lastGame, SimulationStats& stats)
+{
+	using namespace SimulationConstants;
+	using Random = Framework::Utils::Random;
+	using BoardModel = Game::BoardModel;
+
+	Random random(settings.seed);
+	BoardModel model(settings.boardSize, random);
+	model.setSymbolWeights(settings.dropRates);
+
+	BoardModel::Moves moves;
+
+	for (size_t game = firstGame; game < lastGame; ++game)
+	{
+		// Neighbouring seeds are fine, seeding runs them through splitmix
+		random.seed(settings.seed + game);
+		model.generate();
+
+		for (uint32_t move = 0; move < settings.movesPerGame; ++move)
+		{
+			int numRegenerations = 0;
+			while (!model.hasPossibleMoves())
+			{
+				++stats.numDeadBoards;
+				if (++numRegenerations > MaxRegenerationsPerMove)
+				{
+					stats.isUnplayable = true;
+					return;
+				}
+				model.generate();
+			}
+
+			model.findPossibleMoves(moves);
+
+			const BoardModel::Move& chosenMove = moves[random.nextInt(0, static_cast<int>(moves.size()))];
+			const bool isSwapKept = model.trySwap(chosenMove.from, chosenMove.to);
+			assert(isSwapKept);
+			(void)isSwapKept;
+
+			// Stepped here instead of resolveCascade() to count the rounds
+			int cascadeLength = 0;
+			int numRemoved = 0;
+			while (model.hasMatches())
+			{
+				numRemoved += model.removeMatches();
+				model.applyGravity();
+				model.refill();
+				++cascadeLength;
+			}
+
+			const uint64_t points = static_cast<uint64_t>(numRemoved) * Game::Globals::PointsPerMatchedSymbol;
+
+			++stats.numMoves;
+			stats.totalPoints += points;
+			stats.totalSquaredPoints += static_cast<double>(points) * points;
+			++stats.cascadeLengths[std::min(cascadeLength, SimulationStats::MaxCascadeLength)];
+		}
+
+		++stats.numGames;
+	}
+}
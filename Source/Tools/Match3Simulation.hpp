@@ -0,0 +1,84 @@
+//
+// Match3Simulation.hpp
+//
+// @author Roberto Cano
+//
+
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+
+#include "Framework/Core/Types.hpp"
+#include "Framework/Utils/JobSystem.hpp"
+
+namespace Match3
+{
+	namespace Tools
+	{
+		struct SimulationSettings
+		{
+			using Size = Framework::Types::Size;
+
+			Size boardSize = Size(8, 8);
+			// Indexed by symbol type, they need not add up to 1
+			std::vector<float> dropRates;
+
+			uint32_t numGames = 1000;
+			uint32_t movesPerGame = 30;
+
+			// Game i plays from seed + i, so a run replays whatever the number of threads
+			uint64_t seed = 1;
+		};
+
+		struct SimulationStats
+		{
+			// A move that only clears its own match has a cascade of 1, the last bucket holds
+			// everything longer
+			static constexpr int MaxCascadeLength = 10;
+
+			uint64_t numGames = 0;
+			uint64_t numMoves = 0;
+			uint64_t numDeadBoards = 0;
+			uint64_t totalPoints = 0;
+			double totalSquaredPoints = 0.0;
+			std::array<uint64_t, MaxCascadeLength + 1> cascadeLengths = {};
+			// A board kept coming out dead, the games stopped there and the stats are incomplete
+			bool isUnplayable = false;
+
+			void merge(const SimulationStats& other);
+
+			double getPointsPerMove() const;
+			double getPointsPerMoveDeviation() const;
+			double getMeanCascadeLength() const;
+			// Boards left without any possible move, per move played
+			double getDeadBoardRate() const;
+			// Share of the moves with a cascade of the given length
+			double getCascadeShare(int length) const;
+		};
+
+		//
+		// Plays whole games on BoardModel, without any game object, and gathers what happened.
+		// The player makes one of the possible moves at random. A dead board is counted and
+		// generated again, as the game has no shuffle to fall back on, up to a limit per move past
+		// which the settings are taken as unplayable.
+		//
+		// Games are split in chunks over the job system, each with its own generator, and the
+		// chunks are merged in order, so the stats only depend on the settings
+		//
+		class Simulation final
+		{
+		public:
+			explicit Simulation(Framework::Utils::JobSystem& jobSystem);
+
+			SimulationStats run(const SimulationSettings& settings);
+
+		private:
+			static void PlayGames(const SimulationSettings& settings, size_t firstGame, size_t lastGame, SimulationStats& stats);
+
+			Framework::Utils::JobSystem& _jobSystem;
+			std::vector<SimulationStats> _chunkStats;
+		};
+	}
+}